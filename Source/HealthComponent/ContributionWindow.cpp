@@ -0,0 +1,56 @@
+#include "ContributionWindow.h"
+#include "GameFramework/Actor.h"
+
+void FDG_ContributionWindow::Configure(float InWindow, float HalfLife)
+{
+    Window = FMath::Max(InWindow, 0.f);
+    DecayRate = HalfLife > 0.f ? UE_LN2 / HalfLife : 0.0;
+}
+
+void FDG_ContributionWindow::Add(AActor* Actor, double Amount, double Time)
+{
+    if (!Actor || Amount <= 0.0)
+    {
+        return;
+    }
+
+    const TObjectKey<AActor> Key(Actor);
+
+    if (const int32* Found = ContributionIndices.Find(Key))
+    {
+        FDG_Contribution& Contribution = Contributions[*Found];
+        Contribution.Amount = Contribution.Amount * GetDecayScale(Time - Contribution.LastTime) + Amount;
+        Contribution.LastTime = Time;
+        return;
+    }
+
+    if (Contributions.Num() >= PruneThreshold)
+    {
+        Prune(Time);
+    }
+
+    ContributionIndices.Add(Key, Contributions.Add({ Actor, Amount, Time }));
+}
+
+void FDG_ContributionWindow::Reset()
+{
+    Contributions.Reset();
+    ContributionIndices.Reset();
+}
+
+void FDG_ContributionWindow::Prune(double Time)
+{
+    Contributions.RemoveAll([this, Time](const FDG_Contribution& Contribution)
+    {
+        return Time - Contribution.LastTime > Window || !Contribution.Actor.IsValid();
+    });
+
+    ContributionIndices.Reset();
+    for (int32 Index = 0; Index < Contributions.Num(); ++Index)
+    {
+        ContributionIndices.Add(Contributions[Index].Actor.Get(), Index);
+    }
+
+    // Keep pruning amortized when most sources are still inside the window.
+    PruneThreshold = FMath::Max(16, Contributions.Num() * 2);
+}
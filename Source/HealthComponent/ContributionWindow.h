@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+
+struct FDG_Contribution
+{
+    TWeakObjectPtr<AActor> Actor;
+
+    // Amount decayed up to LastTime.
+    double Amount = 0.0;
+
+    double LastTime = 0.0;
+};
+
+// Time stamped contribution per source, decayed exponentially.
+// Adding is a hash lookup regardless of the number of sources, and entries older than the window are pruned in bulk.
+class HEALTHCOMPONENT_API FDG_ContributionWindow
+{
+public:
+    // HalfLife <= 0 disables decay.
+    void Configure(float InWindow, float HalfLife);
+
+    void Add(AActor* Actor, double Amount, double Time);
+
+    void Reset();
+
+    // Calls Visitor(Actor, DecayedAmount) for every source that contributed within the window.
+    template<typename VisitorType>
+    void ForEachRecent(double Time, VisitorType&& Visitor) const
+    {
+        for (const FDG_Contribution& Contribution : Contributions)
+        {
+            if (Time - Contribution.LastTime <= Window)
+            {
+                if (AActor* Actor = Contribution.Actor.Get())
+                {
+                    Visitor(Actor, Contribution.Amount * GetDecayScale(Time - Contribution.LastTime));
+                }
+            }
+        }
+    }
+
+    int32 Num() const { return Contributions.Num(); }
+
+private:
+    double GetDecayScale(double Elapsed) const { return DecayRate > 0.0 ? FMath::Exp(-DecayRate * Elapsed) : 1.0; }
+
+    void Prune(double Time);
+
+    TArray<FDG_Contribution> Contributions;
+
+    TMap<TObjectKey<AActor>, int32> ContributionIndices;
+
+    float Window = 10.f;
+
+    // Decay per second, 0 when decay is disabled.
+    double DecayRate = 0.0;
+
+    // Prune once the window holds this many sources. Grows with the number of sources still inside the window.
+    int32 PruneThreshold = 16;
+};
@@ -0,0 +1,906 @@
+#include "DamageCapture.h"
+
+#if DG_HEALTH_CAPTURE
+
+#include "HealthComponent.h"
+#include "HealthComponentLogItem.h"
+#include "DamageEvent.h"
+#include "HealEvent.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/DamageType.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace DG_DamageCapture
+{
+    // "DGHC"
+    static constexpr uint32 Magic = 0x43484744;
+
+    static constexpr uint32 Version = 3;
+
+    static constexpr double VerifyTolerance = 1.e-6;
+
+    // Indices are stored packed and offset by 1 so INDEX_NONE costs a single byte.
+    static void SerializeIndex(FArchive& Ar, int32& Index)
+    {
+        uint32 Packed = static_cast<uint32>(Index + 1);
+        Ar.SerializeIntPacked(Packed);
+        Index = static_cast<int32>(Packed) - 1;
+    }
+
+    static void SerializeLog(FArchive& Ar, TArray<FDG_DamageCaptureLogItem>& Log)
+    {
+        int32 Num = Log.Num();
+        Ar << Num;
+
+        if (Ar.IsLoading())
+        {
+            if (Num < 0 || Num > Ar.TotalSize() - Ar.Tell())
+            {
+                Ar.SetError();
+                return;
+            }
+            Log.SetNum(Num);
+        }
+
+        for (FDG_DamageCaptureLogItem& Item : Log)
+        {
+            Ar << Item.ActorName;
+            Ar << Item.Amount;
+            SerializeIndex(Ar, Item.NameIndex);
+        }
+    }
+
+    static void SerializeTarget(FArchive& Ar, FDG_DamageCaptureTarget& Target)
+    {
+        SerializeIndex(Ar, Target.NameIndex);
+        Ar << Target.ComponentClass;
+        Ar << Target.MaxHealth;
+        Ar << Target.InitialHealth;
+        Ar << Target.LogSize;
+        Ar << Target.InitialLOD;
+        SerializeLog(Ar, Target.InitialDamageLog);
+        SerializeLog(Ar, Target.InitialHealingLog);
+    }
+
+    static bool IsValidIndexOrNone(int32 Index, int32 Num)
+    {
+        return Index == INDEX_NONE || (Index >= 0 && Index < Num);
+    }
+
+    static bool IsValidLog(const TArray<FDG_DamageCaptureLogItem>& Log, int32 NumNames)
+    {
+        return Log.FindByPredicate([NumNames](const FDG_DamageCaptureLogItem& Item) { return !IsValidIndexOrNone(Item.NameIndex, NumNames); }) == nullptr;
+    }
+
+    static void SerializeFinalState(FArchive& Ar, FDG_DamageCaptureFinalState& State)
+    {
+        SerializeIndex(Ar, State.TargetIndex);
+        Ar << State.CurrentHealth;
+        SerializeLog(Ar, State.DamageLog);
+        SerializeLog(Ar, State.HealingLog);
+    }
+
+    static void CopyLog(const TArray<FDG_HealthComponentLogItem>& Source, TArray<FDG_DamageCaptureLogItem>& Dest)
+    {
+        Dest.Reset(Source.Num());
+        for (const FDG_HealthComponentLogItem& Item : Source)
+        {
+            Dest.Add({ Item.ActorName, Item.Amount });
+        }
+    }
+}
+
+bool FDG_DamageCapture::bRecording = false;
+
+FDG_DamageCapture& FDG_DamageCapture::Get()
+{
+    static FDG_DamageCapture Instance;
+    return Instance;
+}
+
+void FDG_DamageCapture::Start()
+{
+    Reset();
+
+    StartFrame = GFrameCounter;
+    LastFrame = StartFrame;
+    bRecording = true;
+
+    UE_LOG(LogHealthComponent, Log, TEXT("Damage capture started on frame %llu."), StartFrame);
+}
+
+bool FDG_DamageCapture::Stop(const FString& FilePath)
+{
+    if (!bRecording)
+    {
+        return false;
+    }
+
+    bRecording = false;
+
+    TArray<FDG_DamageCaptureFinalState> FinalStates;
+    FinalStates.Reserve(TargetComponents.Num());
+
+    for (int32 TargetIndex = 0; TargetIndex < TargetComponents.Num(); ++TargetIndex)
+    {
+        // Targets that were destroyed during the capture can't be verified.
+        const UDG_HealthComponent* Target = TargetComponents[TargetIndex].Get();
+        if (Target)
+        {
+            FDG_DamageCaptureFinalState& State = FinalStates.AddDefaulted_GetRef();
+            State.TargetIndex = TargetIndex;
+            State.CurrentHealth = Target->CurrentHealth;
+            DG_DamageCapture::CopyLog(Target->DamageLog, State.DamageLog);
+            DG_DamageCapture::CopyLog(Target->HealingLog, State.HealingLog);
+        }
+    }
+
+    TArray<uint8> FileData;
+    FMemoryWriter Writer(FileData);
+
+    uint32 Magic = DG_DamageCapture::Magic;
+    uint32 Version = DG_DamageCapture::Version;
+    Writer << Magic;
+    Writer << Version;
+    Writer << Names;
+    Writer << DamageTypes;
+
+    int32 NumTargets = Targets.Num();
+    Writer << NumTargets;
+    for (FDG_DamageCaptureTarget& Target : Targets)
+    {
+        DG_DamageCapture::SerializeTarget(Writer, Target);
+    }
+
+    Writer << NumRecords;
+    Writer << RecordData;
+
+    int32 NumFinalStates = FinalStates.Num();
+    Writer << NumFinalStates;
+    for (FDG_DamageCaptureFinalState& State : FinalStates)
+    {
+        DG_DamageCapture::SerializeFinalState(Writer, State);
+    }
+
+    const bool bSaved = FFileHelper::SaveArrayToFile(FileData, *FilePath);
+    if (bSaved)
+    {
+        UE_LOG(LogHealthComponent, Log, TEXT("Damage capture wrote %d records for %d targets over %llu frames to %s (%d bytes)."),
+            NumRecords, Targets.Num(), LastFrame - StartFrame, *FilePath, FileData.Num());
+    }
+    else
+    {
+        UE_LOG(LogHealthComponent, Error, TEXT("Damage capture failed to write %s."), *FilePath);
+    }
+
+    Reset();
+    return bSaved;
+}
+
+void FDG_DamageCapture::RecordDamage(UDG_HealthComponent* Target, float Damage, const UDamageType* DamageType, AActor* DamageCauser)
+{
+    const int32 TargetIndex = FindOrAddTarget(Target);
+
+    int32 DamageTypeIndex = INDEX_NONE;
+    if (DamageType)
+    {
+        const UClass* DamageTypeClass = DamageType->GetClass();
+        if (const int32* Found = DamageTypeIndices.Find(DamageTypeClass))
+        {
+            DamageTypeIndex = *Found;
+        }
+        else
+        {
+            DamageTypeIndex = DamageTypes.Add(DamageTypeClass->GetPathName());
+            DamageTypeIndices.Add(DamageTypeClass, DamageTypeIndex);
+        }
+    }
+
+    int32 CauserNameIndex = DamageCauser ? FindOrAddName(DamageCauser->GetName()) : INDEX_NONE;
+
+    FMemoryWriter Writer(RecordData, false, true);
+
+    WriteRecordHeader(Writer, EDG_DamageCaptureRecordKind::Damage, TargetIndex);
+    Writer << Damage;
+    DG_DamageCapture::SerializeIndex(Writer, DamageTypeIndex);
+    DG_DamageCapture::SerializeIndex(Writer, CauserNameIndex);
+}
+
+void FDG_DamageCapture::RecordRegen(UDG_HealthComponent* Target, double Amount)
+{
+    RecordDouble(Target, EDG_DamageCaptureRecordKind::Regen, Amount);
+}
+
+void FDG_DamageCapture::RecordSetHealth(UDG_HealthComponent* Target, double NewHealth)
+{
+    RecordDouble(Target, EDG_DamageCaptureRecordKind::SetHealth, NewHealth);
+}
+
+void FDG_DamageCapture::RecordSetMaxHealth(UDG_HealthComponent* Target, double NewMaxHealth)
+{
+    RecordDouble(Target, EDG_DamageCaptureRecordKind::SetMaxHealth, NewMaxHealth);
+}
+
+void FDG_DamageCapture::RecordInput(UDG_HealthComponent* Target, EDG_DamageCaptureRecordKind Kind)
+{
+    const int32 TargetIndex = FindOrAddTarget(Target);
+
+    FMemoryWriter Writer(RecordData, false, true);
+
+    WriteRecordHeader(Writer, Kind, TargetIndex);
+}
+
+void FDG_DamageCapture::RecordSetLOD(UDG_HealthComponent* Target, uint8 NewLOD)
+{
+    const int32 TargetIndex = FindOrAddTarget(Target);
+
+    FMemoryWriter Writer(RecordData, false, true);
+
+    WriteRecordHeader(Writer, EDG_DamageCaptureRecordKind::SetLOD, TargetIndex);
+    Writer << NewLOD;
+}
+
+FString FDG_DamageCapture::GetDefaultCaptureFilePath()
+{
+    return FPaths::Combine(FPaths::ProfilingDir(), TEXT("HealthCapture"), FString::Printf(TEXT("%s.dghc"), *FDateTime::Now().ToString()));
+}
+
+int32 FDG_DamageCapture::FindOrAddName(const FString& Name)
+{
+    if (const int32* Found = NameIndices.Find(Name))
+    {
+        return *Found;
+    }
+
+    const int32 Index = Names.Add(Name);
+    NameIndices.Add(Name, Index);
+    return Index;
+}
+
+int32 FDG_DamageCapture::FindOrAddTarget(UDG_HealthComponent* Target)
+{
+    if (const int32* Found = TargetIndices.Find(Target))
+    {
+        return *Found;
+    }
+
+    AActor* Owner = Target->GetOwner();
+
+    FDG_DamageCaptureTarget& NewTarget = Targets.AddDefaulted_GetRef();
+    NewTarget.NameIndex = FindOrAddName(Owner ? Owner->GetName() : Target->GetName());
+    NewTarget.ComponentClass = Target->GetClass()->GetPathName();
+    NewTarget.MaxHealth = Target->MaxHealth;
+    NewTarget.InitialHealth = Target->CurrentHealth;
+    NewTarget.LogSize = Target->LogSize;
+    NewTarget.InitialLOD = static_cast<uint8>(Target->HealthLOD);
+
+    // Captures usually start in the middle of a fight, the logs are part of the starting state.
+    CaptureLog(Target->DamageLog, NewTarget.InitialDamageLog);
+    CaptureLog(Target->HealingLog, NewTarget.InitialHealingLog);
+
+    const int32 Index = TargetComponents.Add(Target);
+    TargetIndices.Add(Target, Index);
+    return Index;
+}
+
+void FDG_DamageCapture::CaptureLog(const TArray<FDG_HealthComponentLogItem>& Source, TArray<FDG_DamageCaptureLogItem>& Dest)
+{
+    Dest.Reset(Source.Num());
+    for (const FDG_HealthComponentLogItem& Item : Source)
+    {
+        const AActor* Actor = Item.Actor.Get();
+        Dest.Add({ Item.ActorName, Item.Amount, Actor ? FindOrAddName(Actor->GetName()) : INDEX_NONE });
+    }
+}
+
+void FDG_DamageCapture::WriteRecordHeader(FArchive& Writer, EDG_DamageCaptureRecordKind Kind, int32 TargetIndex)
+{
+    // Frames are stored as a delta from the previous record, most records share a frame and cost a single byte.
+    const uint64 Frame = GFrameCounter;
+    uint32 FrameDelta = static_cast<uint32>(Frame - LastFrame);
+    LastFrame = Frame;
+
+    uint8 KindByte = static_cast<uint8>(Kind);
+
+    Writer.SerializeIntPacked(FrameDelta);
+    Writer << KindByte;
+    DG_DamageCapture::SerializeIndex(Writer, TargetIndex);
+
+    // Almost every record is an outermost input, the stage is only stored for nested ones.
+    Writer.SerializeIntPacked(RecordDepth);
+    if (RecordDepth > 0)
+    {
+        Writer.SerializeIntPacked(RecordStage);
+    }
+
+    ++NumRecords;
+}
+
+void FDG_DamageCapture::RecordDouble(UDG_HealthComponent* Target, EDG_DamageCaptureRecordKind Kind, double Value)
+{
+    const int32 TargetIndex = FindOrAddTarget(Target);
+
+    FMemoryWriter Writer(RecordData, false, true);
+
+    WriteRecordHeader(Writer, Kind, TargetIndex);
+    Writer << Value;
+}
+
+void FDG_DamageCapture::Reset()
+{
+    Names.Reset();
+    NameIndices.Reset();
+    DamageTypes.Reset();
+    DamageTypeIndices.Reset();
+    Targets.Reset();
+    TargetIndices.Reset();
+    TargetComponents.Reset();
+    RecordData.Reset();
+    NumRecords = 0;
+}
+
+bool FDG_DamageReplayer::LoadFromFile(const FString& FilePath)
+{
+    TArray<uint8> FileData;
+    if (!FFileHelper::LoadFileToArray(FileData, *FilePath))
+    {
+        UE_LOG(LogHealthComponent, Error, TEXT("Damage replay failed to read %s."), *FilePath);
+        return false;
+    }
+
+    FMemoryReader Reader(FileData);
+
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    Reader << Magic;
+    Reader << Version;
+
+    if (Magic != DG_DamageCapture::Magic || Version != DG_DamageCapture::Version)
+    {
+        UE_LOG(LogHealthComponent, Error, TEXT("%s is not a damage capture or was written by another version."), *FilePath);
+        return false;
+    }
+
+    Reader << Names;
+    Reader << DamageTypes;
+
+    int32 NumTargets = 0;
+    Reader << NumTargets;
+    if (NumTargets < 0 || NumTargets > Reader.TotalSize())
+    {
+        UE_LOG(LogHealthComponent, Error, TEXT("Damage capture %s is corrupt."), *FilePath);
+        return false;
+    }
+    Targets.SetNum(NumTargets);
+    for (FDG_DamageCaptureTarget& Target : Targets)
+    {
+        DG_DamageCapture::SerializeTarget(Reader, Target);
+    }
+
+    int32 NumRecords = 0;
+    TArray<uint8> RecordData;
+    Reader << NumRecords;
+    Reader << RecordData;
+
+    int32 NumFinalStates = 0;
+    Reader << NumFinalStates;
+    if (NumFinalStates < 0 || NumFinalStates > Reader.TotalSize())
+    {
+        UE_LOG(LogHealthComponent, Error, TEXT("Damage capture %s is corrupt."), *FilePath);
+        return false;
+    }
+    FinalStates.SetNum(NumFinalStates);
+    for (FDG_DamageCaptureFinalState& State : FinalStates)
+    {
+        DG_DamageCapture::SerializeFinalState(Reader, State);
+    }
+
+    if (Reader.IsError())
+    {
+        UE_LOG(LogHealthComponent, Error, TEXT("Damage capture %s is truncated."), *FilePath);
+        return false;
+    }
+
+    // Decode the records up front so replay timing only measures the health pipeline.
+    FMemoryReader RecordReader(RecordData);
+    Records.Reset(FMath::Clamp<int32>(NumRecords, 0, RecordData.Num()));
+
+    uint32 Frame = 0;
+    for (int32 Index = 0; Index < NumRecords && !RecordReader.IsError(); ++Index)
+    {
+        FDG_DamageCaptureRecord& Record = Records.AddDefaulted_GetRef();
+
+        uint32 FrameDelta = 0;
+        uint8 KindByte = 0;
+        RecordReader.SerializeIntPacked(FrameDelta);
+        RecordReader << KindByte;
+        DG_DamageCapture::SerializeIndex(RecordReader, Record.TargetIndex);
+
+        RecordReader.SerializeIntPacked(Record.Depth);
+        if (Record.Depth > 0)
+        {
+            RecordReader.SerializeIntPacked(Record.Stage);
+        }
+
+        Frame += FrameDelta;
+        Record.Frame = Frame;
+
+        if (KindByte >= static_cast<uint8>(EDG_DamageCaptureRecordKind::Num))
+        {
+            RecordReader.SetError();
+            break;
+        }
+        Record.Kind = static_cast<EDG_DamageCaptureRecordKind>(KindByte);
+
+        switch (Record.Kind)
+        {
+        case EDG_DamageCaptureRecordKind::Damage:
+            {
+                float Damage = 0.f;
+                RecordReader << Damage;
+                Record.Amount = Damage;
+                DG_DamageCapture::SerializeIndex(RecordReader, Record.DamageTypeIndex);
+                DG_DamageCapture::SerializeIndex(RecordReader, Record.CauserNameIndex);
+            }
+            break;
+        case EDG_DamageCaptureRecordKind::Regen:
+        case EDG_DamageCaptureRecordKind::SetHealth:
+        case EDG_DamageCaptureRecordKind::SetMaxHealth:
+            RecordReader << Record.Amount;
+            break;
+        case EDG_DamageCaptureRecordKind::SetLOD:
+            {
+                uint8 LOD = 0;
+                RecordReader << LOD;
+                Record.Amount = LOD;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (RecordReader.IsError() || Records.Num() != NumRecords || !Validate())
+    {
+        UE_LOG(LogHealthComponent, Error, TEXT("Damage capture %s has corrupt records."), *FilePath);
+        return false;
+    }
+
+    NextRecord = 0;
+    ReplayFrame = 0;
+    Result = FDG_DamageReplayResult();
+    return true;
+}
+
+bool FDG_DamageReplayer::Validate() const
+{
+    using namespace DG_DamageCapture;
+
+    constexpr uint8 MaxLOD = static_cast<uint8>(EDG_HealthLOD::Minimal);
+
+    for (const FDG_DamageCaptureTarget& Target : Targets)
+    {
+        if (!Names.IsValidIndex(Target.NameIndex) || Target.InitialLOD > MaxLOD
+            || !IsValidLog(Target.InitialDamageLog, Names.Num()) || !IsValidLog(Target.InitialHealingLog, Names.Num()))
+        {
+            return false;
+        }
+    }
+
+    // A record can only be nested one level deeper than the record before it.
+    uint32 PreviousDepth = 0;
+    for (int32 Index = 0; Index < Records.Num(); ++Index)
+    {
+        const FDG_DamageCaptureRecord& Record = Records[Index];
+        if (!Targets.IsValidIndex(Record.TargetIndex)
+            || !IsValidIndexOrNone(Record.DamageTypeIndex, DamageTypes.Num())
+            || !IsValidIndexOrNone(Record.CauserNameIndex, Names.Num())
+            || (Record.Kind == EDG_DamageCaptureRecordKind::SetLOD && Record.Amount > MaxLOD)
+            || (Index == 0 ? Record.Depth != 0 : Record.Depth > PreviousDepth + 1))
+        {
+            return false;
+        }
+        PreviousDepth = Record.Depth;
+    }
+
+    for (const FDG_DamageCaptureFinalState& State : FinalStates)
+    {
+        if (!Targets.IsValidIndex(State.TargetIndex))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FDG_DamageReplayer::Spawn(UWorld* World)
+{
+    if (!World)
+    {
+        return false;
+    }
+
+    ResolvedDamageTypes.Reset(DamageTypes.Num());
+    for (const FString& DamageTypePath : DamageTypes)
+    {
+        UClass* DamageTypeClass = LoadClass<UDamageType>(nullptr, *DamageTypePath);
+        if (!DamageTypeClass)
+        {
+            UE_LOG(LogHealthComponent, Warning, TEXT("Damage replay could not resolve damage type %s, using UDamageType."), *DamageTypePath);
+            DamageTypeClass = UDamageType::StaticClass();
+        }
+
+        ResolvedDamageTypes.Add(GetDefault<UDamageType>(DamageTypeClass));
+    }
+
+    SpawnedActors.Reset();
+    SpawnedActors.SetNum(Names.Num());
+
+    auto SpawnNamedActor = [World](const FString& Name)
+    {
+        FActorSpawnParameters SpawnParameters;
+        SpawnParameters.Name = FName(*Name);
+        SpawnParameters.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+        return World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+    };
+
+    SpawnedTargets.Reset(Targets.Num());
+    for (const FDG_DamageCaptureTarget& Target : Targets)
+    {
+        AActor* Actor = SpawnNamedActor(Names[Target.NameIndex]);
+        if (!Actor)
+        {
+            return false;
+        }
+
+        UClass* ComponentClass = LoadClass<UDG_HealthComponent>(nullptr, *Target.ComponentClass);
+        if (!ComponentClass)
+        {
+            UE_LOG(LogHealthComponent, Warning, TEXT("Damage replay could not resolve component class %s, using UDG_HealthComponent."), *Target.ComponentClass);
+            ComponentClass = UDG_HealthComponent::StaticClass();
+        }
+
+        UDG_HealthComponent* HealthComponent = NewObject<UDG_HealthComponent>(Actor, ComponentClass);
+        HealthComponent->MaxHealth = Target.MaxHealth;
+        HealthComponent->LogSize = Target.LogSize;
+
+        // Regen is replayed from the capture, the timer must not run on its own.
+        HealthComponent->HealthRegen = 0.0;
+        HealthComponent->RegisterComponent();
+
+        // Don't use SetCurrentHealth here as it will trigger Die/Revive.
+        HealthComponent->CurrentHealth = Target.InitialHealth;
+        HealthComponent->HealthLOD = static_cast<EDG_HealthLOD>(Target.InitialLOD);
+
+        // Stand in for the listeners of the capture, every staged broadcast is bound.
+        HealthComponent->OnTakeDamage.AddLambda([this](UDG_HealthComponent*, const FDG_DamageEvent&) { HandleStage(); });
+        HealthComponent->OnReceiveHeal.AddLambda([this](UDG_HealthComponent*, const FDG_HealEvent&) { HandleStage(); });
+        HealthComponent->OnHealthChanged.AddLambda([this](UDG_HealthComponent*) { HandleStage(); });
+        HealthComponent->OnDeath.AddLambda([this](UDG_HealthComponent*) { HandleStage(); });
+        HealthComponent->OnRevive.AddLambda([this](UDG_HealthComponent*) { HandleStage(); });
+        HealthComponent->OnHealthRegen.AddLambda([this](UDG_HealthComponent*, double) { HandleStage(); });
+
+        SpawnedTargets.Add(HealthComponent);
+        SpawnedActors[Target.NameIndex] = Actor;
+    }
+
+    auto SpawnReferencedActor = [this, &SpawnNamedActor](int32 NameIndex)
+    {
+        if (NameIndex != INDEX_NONE && !SpawnedActors[NameIndex].IsValid())
+        {
+            SpawnedActors[NameIndex] = SpawnNamedActor(Names[NameIndex]);
+        }
+    };
+
+    for (const FDG_DamageCaptureRecord& Record : Records)
+    {
+        SpawnReferencedActor(Record.CauserNameIndex);
+    }
+
+    // The initial logs are restored once every actor they reference exists, so later hits from the same actors merge into them.
+    for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+    {
+        const FDG_DamageCaptureTarget& Target = Targets[TargetIndex];
+
+        for (const FDG_DamageCaptureLogItem& Item : Target.InitialDamageLog)
+        {
+            SpawnReferencedActor(Item.NameIndex);
+        }
+
+        for (const FDG_DamageCaptureLogItem& Item : Target.InitialHealingLog)
+        {
+            SpawnReferencedActor(Item.NameIndex);
+        }
+
+        UDG_HealthComponent* HealthComponent = SpawnedTargets[TargetIndex].Get();
+        RestoreLog(Target.InitialDamageLog, HealthComponent->DamageLog);
+        RestoreLog(Target.InitialHealingLog, HealthComponent->HealingLog);
+    }
+
+    return true;
+}
+
+void FDG_DamageReplayer::RestoreLog(const TArray<FDG_DamageCaptureLogItem>& Source, TArray<FDG_HealthComponentLogItem>& Dest) const
+{
+    Dest.Reset();
+    for (const FDG_DamageCaptureLogItem& Item : Source)
+    {
+        AActor* Actor = Item.NameIndex != INDEX_NONE ? SpawnedActors[Item.NameIndex].Get() : nullptr;
+        Dest.Add(FDG_HealthComponentLogItem(Actor, Item.ActorName, Item.Amount));
+    }
+}
+
+bool FDG_DamageReplayer::StepFrame()
+{
+    if (IsFinished())
+    {
+        return false;
+    }
+
+    const uint32 Frame = Records[NextRecord].Frame;
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    while (NextRecord < Records.Num() && Records[NextRecord].Frame == Frame)
+    {
+        ReplayInput();
+    }
+    const double FrameSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+    Result.FrameSeconds.Add(FrameSeconds);
+    Result.TotalSeconds += FrameSeconds;
+    Result.MaxFrameSeconds = FMath::Max(Result.MaxFrameSeconds, FrameSeconds);
+    ++Result.NumFrames;
+
+    return true;
+}
+
+bool FDG_DamageReplayer::TickFrame()
+{
+    if (IsFinished())
+    {
+        return false;
+    }
+
+    if (Records[NextRecord].Frame <= ReplayFrame)
+    {
+        StepFrame();
+    }
+
+    ++ReplayFrame;
+    return !IsFinished();
+}
+
+void FDG_DamageReplayer::ReplayAll()
+{
+    while (StepFrame())
+    {
+    }
+}
+
+void FDG_DamageReplayer::ReplayInput()
+{
+    TGuardValue<bool> ReplayingInputGuard(bReplayingInput, true);
+    StageCounter = 0;
+
+    ReplayRecord(Records[NextRecord++]);
+
+    // Nested records that no broadcast claimed (ie: the replay diverged) are applied after their input.
+    while (NextRecord < Records.Num() && Records[NextRecord].Depth > 0)
+    {
+        const FDG_DamageCaptureRecord& Record = Records[NextRecord++];
+        if (Record.Stage > 0)
+        {
+            ReplayRecord(Record);
+        }
+    }
+}
+
+void FDG_DamageReplayer::HandleStage()
+{
+    if (!bReplayingInput)
+    {
+        return;
+    }
+
+    const uint32 Stage = ++StageCounter;
+
+    // Nested records are in capture order, the ones made from this broadcast are next,
+    // past the calls the enclosing inputs made themselves. Applying them can stage further broadcasts, which consume their own.
+    while (NextRecord < Records.Num() && Records[NextRecord].Depth > 0)
+    {
+        const FDG_DamageCaptureRecord& Record = Records[NextRecord];
+        if (Record.Stage == 0)
+        {
+            // The replayed input makes these calls itself.
+            ++NextRecord;
+            continue;
+        }
+
+        if (Record.Stage != Stage)
+        {
+            break;
+        }
+
+        ++NextRecord;
+        ReplayRecord(Record);
+    }
+}
+
+void FDG_DamageReplayer::ReplayRecord(const FDG_DamageCaptureRecord& Record)
+{
+    UDG_HealthComponent* Target = SpawnedTargets[Record.TargetIndex].Get();
+    if (!Target)
+    {
+        return;
+    }
+
+    ++Result.NumRecords;
+
+    switch (Record.Kind)
+    {
+    case EDG_DamageCaptureRecordKind::Damage:
+        {
+            const UDamageType* DamageType = Record.DamageTypeIndex != INDEX_NONE ? ResolvedDamageTypes[Record.DamageTypeIndex] : nullptr;
+            AActor* DamageCauser = Record.CauserNameIndex != INDEX_NONE ? SpawnedActors[Record.CauserNameIndex].Get() : nullptr;
+
+            Target->HandleOwnerTakeDamage(Target->GetOwner(), static_cast<float>(Record.Amount), DamageType, nullptr, DamageCauser);
+        }
+        break;
+    case EDG_DamageCaptureRecordKind::Regen:
+        Target->ApplyHealthRegen(Record.Amount);
+        break;
+    case EDG_DamageCaptureRecordKind::SetHealth:
+        Target->SetCurrentHealth(Record.Amount);
+        break;
+    case EDG_DamageCaptureRecordKind::SetMaxHealth:
+        Target->SetMaxHealth(Record.Amount);
+        break;
+    case EDG_DamageCaptureRecordKind::Reset:
+        Target->ResetHealth();
+        break;
+    case EDG_DamageCaptureRecordKind::SetLOD:
+        Target->SetHealthLOD(static_cast<EDG_HealthLOD>(Record.Amount));
+        break;
+    case EDG_DamageCaptureRecordKind::ClearDamageLog:
+        Target->ClearDamageLog();
+        break;
+    case EDG_DamageCaptureRecordKind::ClearHealingLog:
+        Target->ClearHealingLog();
+        break;
+    default:
+        break;
+    }
+}
+
+const FDG_DamageReplayResult& FDG_DamageReplayer::Finish()
+{
+    for (const FDG_DamageCaptureFinalState& State : FinalStates)
+    {
+        const UDG_HealthComponent* Target = SpawnedTargets.IsValidIndex(State.TargetIndex) ? SpawnedTargets[State.TargetIndex].Get() : nullptr;
+        if (!Target)
+        {
+            continue;
+        }
+
+        const FString& TargetName = Names[Targets[State.TargetIndex].NameIndex];
+
+        bool bMatches = true;
+        if (!FMath::IsNearlyEqual(Target->CurrentHealth, State.CurrentHealth, DG_DamageCapture::VerifyTolerance))
+        {
+            UE_LOG(LogHealthComponent, Warning, TEXT("Damage replay: %s health is %f, captured %f."), *TargetName, Target->CurrentHealth, State.CurrentHealth);
+            bMatches = false;
+        }
+
+        bMatches &= VerifyLog(TargetName, TEXT("damage"), State.DamageLog, Target->DamageLog);
+        bMatches &= VerifyLog(TargetName, TEXT("healing"), State.HealingLog, Target->HealingLog);
+
+        ++Result.NumVerified;
+        if (!bMatches)
+        {
+            ++Result.NumMismatches;
+        }
+    }
+
+    UE_LOG(LogHealthComponent, Log, TEXT("Damage replay: %d records over %d frames in %.3f ms (avg %.3f us/frame, max %.3f us). Verified %d targets, %d mismatches."),
+        Result.NumRecords, Result.NumFrames, Result.TotalSeconds * 1000.0,
+        Result.NumFrames > 0 ? Result.TotalSeconds * 1000000.0 / Result.NumFrames : 0.0,
+        Result.MaxFrameSeconds * 1000000.0, Result.NumVerified, Result.NumMismatches);
+
+    // Stand-ins left behind would take the names of the next replay's actors in this world.
+    for (const TWeakObjectPtr<AActor>& Actor : SpawnedActors)
+    {
+        if (Actor.IsValid())
+        {
+            Actor->Destroy();
+        }
+    }
+    SpawnedActors.Reset();
+    SpawnedTargets.Reset();
+
+    return Result;
+}
+
+bool FDG_DamageReplayer::VerifyLog(const FString& TargetName, const TCHAR* LogName, const TArray<FDG_DamageCaptureLogItem>& Expected, const TArray<FDG_HealthComponentLogItem>& Actual) const
+{
+    if (Expected.Num() != Actual.Num())
+    {
+        UE_LOG(LogHealthComponent, Warning, TEXT("Damage replay: %s %s log has %d entries, captured %d."), *TargetName, LogName, Actual.Num(), Expected.Num());
+        return false;
+    }
+
+    for (int32 Index = 0; Index < Expected.Num(); ++Index)
+    {
+        if (Expected[Index].ActorName != Actual[Index].ActorName || !FMath::IsNearlyEqual(Expected[Index].Amount, Actual[Index].Amount, DG_DamageCapture::VerifyTolerance))
+        {
+            UE_LOG(LogHealthComponent, Warning, TEXT("Damage replay: %s %s log entry %d is %s %f, captured %s %f."), *TargetName, LogName, Index,
+                *Actual[Index].ActorName, Actual[Index].Amount, *Expected[Index].ActorName, Expected[Index].Amount);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Begin Console Commands
+static FAutoConsoleCommand DG_HealthCaptureStartCommand(
+    TEXT("DG.Health.Capture.Start"),
+    TEXT("Start recording health component damage inputs."),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        FDG_DamageCapture::Get().Start();
+    }));
+
+static FAutoConsoleCommand DG_HealthCaptureStopCommand(
+    TEXT("DG.Health.Capture.Stop"),
+    TEXT("Stop recording and write the capture. Usage: DG.Health.Capture.Stop [File]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        FDG_DamageCapture::Get().Stop(Args.Num() > 0 ? Args[0] : FDG_DamageCapture::GetDefaultCaptureFilePath());
+    }));
+
+// Can be run headless with: -nullrhi -ExecCmds="DG.Health.Replay <File>"
+static FAutoConsoleCommandWithWorldAndArgs DG_HealthReplayCommand(
+    TEXT("DG.Health.Replay"),
+    TEXT("Replay a damage capture into the current world. Usage: DG.Health.Replay <File> [realtime]. Unthrottled unless realtime is passed, which replays at the captured frame pacing."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (Args.Num() < 1)
+        {
+            UE_LOG(LogHealthComponent, Warning, TEXT("Usage: DG.Health.Replay <File> [realtime]"));
+            return;
+        }
+
+        TSharedRef<FDG_DamageReplayer> Replayer = MakeShared<FDG_DamageReplayer>();
+        if (!Replayer->LoadFromFile(Args[0]) || !Replayer->Spawn(World))
+        {
+            return;
+        }
+
+        if (Args.Num() > 1 && Args[1].Equals(TEXT("realtime"), ESearchCase::IgnoreCase))
+        {
+            FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Replayer](float DeltaTime)
+            {
+                if (!Replayer->TickFrame())
+                {
+                    Replayer->Finish();
+                    return false;
+                }
+                return true;
+            }));
+        }
+        else
+        {
+            Replayer->ReplayAll();
+            Replayer->Finish();
+        }
+    }));
+// End Console Commands
+
+#endif // DG_HEALTH_CAPTURE
@@ -0,0 +1,376 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "HealthDevTools.h"
+
+#ifndef DG_HEALTH_CAPTURE
+#define DG_HEALTH_CAPTURE DG_HEALTH_DEV_TOOLS
+#endif
+
+#if DG_HEALTH_CAPTURE
+
+class AActor;
+class UDamageType;
+class UDG_HealthComponent;
+class UWorld;
+
+// The kind of input stored in a capture record.
+enum class EDG_DamageCaptureRecordKind : uint8
+{
+    // A call to HandleOwnerTakeDamage.
+    Damage,
+
+    // Regen applied by the timer or credited by an LOD change. Regen is timer driven so it has to be captured to replay deterministically.
+    Regen,
+
+    // A call to SetCurrentHealth, ApplyDamage and ApplyHeal go through it.
+    SetHealth,
+
+    SetMaxHealth,
+
+    // A call to ResetHealth.
+    Reset,
+
+    // A call to SetHealthLOD, logging is suspended below full LOD.
+    SetLOD,
+
+    ClearDamageLog,
+
+    ClearHealingLog,
+
+    Num,
+};
+
+// A single log entry, stored by name because the actors won't exist on replay.
+struct FDG_DamageCaptureLogItem
+{
+    FString ActorName;
+
+    double Amount = 0.0;
+
+    // Index into the capture name table for the logged actor, INDEX_NONE if it was destroyed.
+    // Only used to relink the initial logs on replay.
+    int32 NameIndex = INDEX_NONE;
+};
+
+// A health component seen during the capture, with its state when it was first seen.
+struct FDG_DamageCaptureTarget
+{
+    // Index into the capture name table, this is the name of the owning actor.
+    int32 NameIndex = INDEX_NONE;
+
+    // Path of the component class so subclass overrides replay too.
+    FString ComponentClass;
+
+    double MaxHealth = 0.0;
+
+    double InitialHealth = 0.0;
+
+    int32 LogSize = 0;
+
+    uint8 InitialLOD = 0;
+
+    TArray<FDG_DamageCaptureLogItem> InitialDamageLog;
+
+    TArray<FDG_DamageCaptureLogItem> InitialHealingLog;
+};
+
+// State of a target when the capture was stopped. Used to verify a replay.
+struct FDG_DamageCaptureFinalState
+{
+    int32 TargetIndex = INDEX_NONE;
+
+    double CurrentHealth = 0.0;
+
+    TArray<FDG_DamageCaptureLogItem> DamageLog;
+
+    TArray<FDG_DamageCaptureLogItem> HealingLog;
+};
+
+// Decoded capture record.
+struct FDG_DamageCaptureRecord
+{
+    EDG_DamageCaptureRecordKind Kind = EDG_DamageCaptureRecordKind::Damage;
+
+    uint32 Frame = 0;
+
+    int32 TargetIndex = INDEX_NONE;
+
+    // Damage, regen, health or max health depending on Kind. The LOD for SetLOD records.
+    double Amount = 0.0;
+
+    // Index into the damage type table.
+    int32 DamageTypeIndex = INDEX_NONE;
+
+    // Index into the name table, INDEX_NONE when there was no causer.
+    int32 CauserNameIndex = INDEX_NONE;
+
+    // Number of recorded inputs this one was made from inside of, 0 for inputs from outside the health components.
+    uint32 Depth = 0;
+
+    // For nested records, the staged broadcast of the enclosing input it was made from, counted from the start of the outermost input.
+    // 0 when it was made by the enclosing input itself (ie: ResetHealth clearing the logs), the replayed input makes those calls again.
+    uint32 Stage = 0;
+};
+
+// Records the exact inputs of the health pipeline into a compact binary stream.
+// Calls made from inside a recorded input (ie: a listener resetting health on death) are recorded with their depth and
+// the staged broadcast they were made from, so the replay can make them from the same point of the pipeline.
+// Start it with DG.Health.Capture.Start and write it out with DG.Health.Capture.Stop [File].
+class HEALTHCOMPONENT_API FDG_DamageCapture
+{
+    friend struct FDG_DamageCaptureInputScope;
+    friend struct FDG_DamageCaptureStageScope;
+
+public:
+    static FDG_DamageCapture& Get();
+
+    static bool IsRecording() { return bRecording; }
+
+    void Start();
+
+    // Stops recording and writes the capture to disk. Returns false if nothing could be written.
+    bool Stop(const FString& FilePath);
+
+    void RecordDamage(UDG_HealthComponent* Target, float Damage, const UDamageType* DamageType, AActor* DamageCauser);
+
+    // Amount is the regen actually applied, already scaled by the LOD.
+    void RecordRegen(UDG_HealthComponent* Target, double Amount);
+
+    void RecordSetHealth(UDG_HealthComponent* Target, double NewHealth);
+
+    void RecordSetMaxHealth(UDG_HealthComponent* Target, double NewMaxHealth);
+
+    // Records an input without a payload (ie: Reset, ClearDamageLog).
+    void RecordInput(UDG_HealthComponent* Target, EDG_DamageCaptureRecordKind Kind);
+
+    void RecordSetLOD(UDG_HealthComponent* Target, uint8 NewLOD);
+
+    static FString GetDefaultCaptureFilePath();
+
+private:
+    int32 FindOrAddName(const FString& Name);
+
+    int32 FindOrAddTarget(UDG_HealthComponent* Target);
+
+    void CaptureLog(const TArray<struct FDG_HealthComponentLogItem>& Source, TArray<FDG_DamageCaptureLogItem>& Dest);
+
+    void WriteRecordHeader(FArchive& Writer, EDG_DamageCaptureRecordKind Kind, int32 TargetIndex);
+
+    void RecordDouble(UDG_HealthComponent* Target, EDG_DamageCaptureRecordKind Kind, double Value);
+
+    void Reset();
+
+    static bool bRecording;
+
+    TArray<FString> Names;
+
+    TMap<FString, int32> NameIndices;
+
+    TArray<FString> DamageTypes;
+
+    TMap<const UClass*, int32> DamageTypeIndices;
+
+    TArray<FDG_DamageCaptureTarget> Targets;
+
+    TMap<TObjectKey<UDG_HealthComponent>, int32> TargetIndices;
+
+    // Components are kept weakly so their final state can be read when the capture stops.
+    TArray<TWeakObjectPtr<UDG_HealthComponent>> TargetComponents;
+
+    // Encoded records, the tables are only written when the capture stops.
+    TArray<uint8> RecordData;
+
+    int32 NumRecords = 0;
+
+    uint64 StartFrame = 0;
+
+    uint64 LastFrame = 0;
+
+    // Nesting of the inputs being recorded, maintained by FDG_DamageCaptureInputScope.
+    uint32 InputDepth = 0;
+
+    // Staged broadcasts since the outermost input started, and the one the current input is inside of.
+    uint32 StageCounter = 0;
+
+    uint32 CurrentStage = 0;
+
+    // Depth and stage of the input about to be recorded.
+    uint32 RecordDepth = 0;
+
+    uint32 RecordStage = 0;
+};
+
+// Brackets a recorded input so the calls made while it runs are recorded as nested in it.
+struct FDG_DamageCaptureInputScope
+{
+    explicit FDG_DamageCaptureInputScope(bool bEnabled = true)
+        : bActive(bEnabled && FDG_DamageCapture::IsRecording())
+    {
+        if (bActive)
+        {
+            FDG_DamageCapture& Capture = FDG_DamageCapture::Get();
+            if (Capture.InputDepth == 0)
+            {
+                Capture.StageCounter = 0;
+            }
+
+            Capture.RecordDepth = Capture.InputDepth++;
+            Capture.RecordStage = Capture.CurrentStage;
+
+            SavedStage = Capture.CurrentStage;
+            Capture.CurrentStage = 0;
+        }
+    }
+
+    ~FDG_DamageCaptureInputScope()
+    {
+        if (bActive)
+        {
+            FDG_DamageCapture& Capture = FDG_DamageCapture::Get();
+            --Capture.InputDepth;
+            Capture.CurrentStage = SavedStage;
+        }
+    }
+
+private:
+    bool bActive;
+
+    uint32 SavedStage = 0;
+};
+
+// Brackets the broadcast of a delegate the replayer listens to (OnTakeDamage, OnReceiveHeal, OnHealthChanged, OnDeath, OnRevive and OnHealthRegen).
+struct FDG_DamageCaptureStageScope
+{
+    explicit FDG_DamageCaptureStageScope(bool bEnabled = true)
+        : bActive(bEnabled && FDG_DamageCapture::IsRecording() && FDG_DamageCapture::Get().InputDepth > 0)
+    {
+        if (bActive)
+        {
+            FDG_DamageCapture& Capture = FDG_DamageCapture::Get();
+            SavedStage = Capture.CurrentStage;
+            Capture.CurrentStage = ++Capture.StageCounter;
+        }
+    }
+
+    ~FDG_DamageCaptureStageScope()
+    {
+        if (bActive)
+        {
+            FDG_DamageCapture::Get().CurrentStage = SavedStage;
+        }
+    }
+
+private:
+    bool bActive;
+
+    uint32 SavedStage = 0;
+};
+
+struct FDG_DamageReplayResult
+{
+    int32 NumFrames = 0;
+
+    int32 NumRecords = 0;
+
+    // Time spent in the health pipeline for each replayed frame.
+    TArray<double> FrameSeconds;
+
+    double TotalSeconds = 0.0;
+
+    double MaxFrameSeconds = 0.0;
+
+    int32 NumVerified = 0;
+
+    int32 NumMismatches = 0;
+
+    bool Succeeded() const { return NumMismatches == 0; }
+};
+
+// Replays a capture against stand-in actors spawned in a world.
+// The world should be empty (ie: a -nullrhi game on an empty map) so actor names don't collide.
+class HEALTHCOMPONENT_API FDG_DamageReplayer
+{
+public:
+    bool LoadFromFile(const FString& FilePath);
+
+    // Spawns a stand-in actor with a health component for every target, and a plain actor for every causer.
+    bool Spawn(UWorld* World);
+
+    // Replays every record of the next captured frame that has any. Returns false once the capture is exhausted.
+    bool StepFrame();
+
+    // Advances the replay by one frame at the captured pacing, empty captured frames replay nothing.
+    // Returns false once the capture is exhausted.
+    bool TickFrame();
+
+    // Replays the whole capture without waiting between frames.
+    void ReplayAll();
+
+    // Compares the final health and logs of every target against the capture, logs a summary and destroys the stand-in actors.
+    const FDG_DamageReplayResult& Finish();
+
+    bool IsFinished() const { return NextRecord >= Records.Num(); }
+
+private:
+    // Checks every decoded index against its table so a corrupt file can't index out of range.
+    bool Validate() const;
+
+    // Replays the outermost input at NextRecord and the records nested in it.
+    void ReplayInput();
+
+    // Called from the staged delegates of the spawned components, applies the nested records made from that broadcast.
+    void HandleStage();
+
+    void ReplayRecord(const FDG_DamageCaptureRecord& Record);
+
+    void RestoreLog(const TArray<FDG_DamageCaptureLogItem>& Source, TArray<struct FDG_HealthComponentLogItem>& Dest) const;
+
+    bool VerifyLog(const FString& TargetName, const TCHAR* LogName, const TArray<FDG_DamageCaptureLogItem>& Expected, const TArray<struct FDG_HealthComponentLogItem>& Actual) const;
+
+    TArray<FString> Names;
+
+    TArray<FString> DamageTypes;
+
+    TArray<FDG_DamageCaptureTarget> Targets;
+
+    TArray<FDG_DamageCaptureRecord> Records;
+
+    TArray<FDG_DamageCaptureFinalState> FinalStates;
+
+    TArray<TWeakObjectPtr<UDG_HealthComponent>> SpawnedTargets;
+
+    // Stand-in actors by name index, a target can also be a causer.
+    TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+
+    TArray<const UDamageType*> ResolvedDamageTypes;
+
+    int32 NextRecord = 0;
+
+    // Frame reached by TickFrame, relative to the start of the capture.
+    uint32 ReplayFrame = 0;
+
+    // Only set while ReplayInput runs, the spawned components also broadcast on their own (ie: regen timers).
+    bool bReplayingInput = false;
+
+    // Staged broadcasts since the input being replayed started.
+    uint32 StageCounter = 0;
+
+    FDG_DamageReplayResult Result;
+};
+
+// Opens the input scope for the rest of the enclosing block, the record has to be written right after it.
+#define DG_HEALTH_CAPTURE_INPUT(bEnabled) FDG_DamageCaptureInputScope DGHealthCaptureInputScope(bEnabled);
+#define DG_HEALTH_CAPTURE_WRITE(Call) if (FDG_DamageCapture::IsRecording()) { FDG_DamageCapture::Get().Call; }
+#define DG_HEALTH_CAPTURE_RECORD(Call) DG_HEALTH_CAPTURE_INPUT(true) DG_HEALTH_CAPTURE_WRITE(Call)
+#define DG_HEALTH_CAPTURE_STAGE(bEnabled) FDG_DamageCaptureStageScope DGHealthCaptureStageScope(bEnabled);
+
+#else
+
+#define DG_HEALTH_CAPTURE_INPUT(bEnabled)
+#define DG_HEALTH_CAPTURE_WRITE(Call)
+#define DG_HEALTH_CAPTURE_RECORD(Call)
+#define DG_HEALTH_CAPTURE_STAGE(bEnabled)
+
+#endif // DG_HEALTH_CAPTURE
@@ -1,5 +1,7 @@
 #pragma once
 #include "Engine/DamageEvents.h"
+#include "GameFramework/DamageType.h"
+#include "DamageTypeRegistry.h"
 #include "DamageEvent.generated.h"
 
 USTRUCT(BlueprintType, Blueprintable)
@@ -20,13 +22,27 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     bool bDamageModified = false;
 
+    // Id and traits of DamageTypeClass from FDG_DamageTypeRegistry.
+    uint16 DamageTypeId = 0;
+
+    EDG_DamageTypeTraits DamageTypeTraits = EDG_DamageTypeTraits::None;
+
 public:
     FDG_DamageEvent() {}
 
     FDG_DamageEvent(double Damage, const UDamageType* DamageType)
+        : FDG_DamageEvent(Damage, DamageType, FDG_DamageTypeRegistry::Get().Find(DamageType))
+    {
+
+    }
+
+    // Use this when the registry info was already looked up.
+    FDG_DamageEvent(double Damage, const UDamageType* DamageType, const FDG_DamageTypeInfo& DamageTypeInfo)
         : InitialDamage(Damage)
         , FinalDamage(InitialDamage)
         , bDamageModified(false)
+        , DamageTypeId(DamageTypeInfo.Id)
+        , DamageTypeTraits(DamageTypeInfo.Traits)
     {
         if (DamageType)
         {
@@ -38,6 +54,12 @@ public:
 
     double GetFinalDamage() const { return FinalDamage; }
 
+    uint16 GetDamageTypeId() const { return DamageTypeId; }
+
+    EDG_DamageTypeTraits GetDamageTypeTraits() const { return DamageTypeTraits; }
+
+    bool HasDamageTypeTrait(EDG_DamageTypeTraits Trait) const { return EnumHasAnyFlags(DamageTypeTraits, Trait); }
+
 protected:
     virtual void ModifyDamage(double NewDamage)
     {
@@ -55,10 +77,50 @@ UCLASS()
 class HEALTHCOMPONENT_API UDG_DamageType : public UDamageType
 {
     GENERATED_BODY()
+
+public:
+    // Read once from the class default object by FDG_DamageTypeRegistry.
+    virtual EDG_DamageTypeTraits GetTraits() const
+    {
+        EDG_DamageTypeTraits Traits = EDG_DamageTypeTraits::None;
+
+        if (bPeriodic)
+        {
+            Traits |= EDG_DamageTypeTraits::Periodic;
+        }
+
+        if (bTrueDamage)
+        {
+            Traits |= EDG_DamageTypeTraits::TrueDamage;
+        }
+
+        if (bIgnoresShields)
+        {
+            Traits |= EDG_DamageTypeTraits::IgnoresShields;
+        }
+
+        return Traits;
+    }
+
+protected:
+    UPROPERTY(EditDefaultsOnly, Category="Traits")
+    bool bPeriodic = false;
+
+    UPROPERTY(EditDefaultsOnly, Category="Traits")
+    bool bTrueDamage = false;
+
+    UPROPERTY(EditDefaultsOnly, Category="Traits")
+    bool bIgnoresShields = false;
 };
 
 UCLASS()
 class HEALTHCOMPONENT_API UDG_DamageType_Heal : public UDG_DamageType
 {
     GENERATED_BODY()
+
+public:
+    virtual EDG_DamageTypeTraits GetTraits() const override
+    {
+        return Super::GetTraits() | EDG_DamageTypeTraits::Heal;
+    }
 };
@@ -0,0 +1,139 @@
+#include "DamageTypeRegistry.h"
+#include "DamageEvent.h"
+#include "GameFramework/DamageType.h"
+#include "UObject/UObjectIterator.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
+FDG_DamageTypeRegistry& FDG_DamageTypeRegistry::Get()
+{
+    static FDG_DamageTypeRegistry Instance;
+    return Instance;
+}
+
+FDG_DamageTypeRegistry::FDG_DamageTypeRegistry()
+{
+    // Id 0 is "no damage type".
+    Infos.AddDefaulted();
+    Classes.AddDefaulted();
+}
+
+void FDG_DamageTypeRegistry::Initialize()
+{
+    check(IsInGameThread());
+
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        if (It->IsChildOf(UDamageType::StaticClass()) && CanRegister(*It) && !ClassIds.Contains(*It))
+        {
+            Register(*It);
+        }
+    }
+
+#if WITH_EDITOR
+    // Trait defaults can be edited on blueprint damage types, the class object is kept when they are recompiled.
+    if (GEditor && !BlueprintCompiledHandle.IsValid())
+    {
+        BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FDG_DamageTypeRegistry::RefreshTraits);
+    }
+#endif
+}
+
+void FDG_DamageTypeRegistry::Shutdown()
+{
+#if WITH_EDITOR
+    if (GEditor)
+    {
+        GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+    }
+#endif
+    BlueprintCompiledHandle.Reset();
+}
+
+FDG_DamageTypeInfo FDG_DamageTypeRegistry::Find(const UDamageType* DamageType)
+{
+    return DamageType ? Find(DamageType->GetClass()) : Infos[0];
+}
+
+FDG_DamageTypeInfo FDG_DamageTypeRegistry::Find(const UClass* DamageTypeClass)
+{
+    if (!DamageTypeClass)
+    {
+        return Infos[0];
+    }
+
+    if (const uint16* Id = ClassIds.Find(DamageTypeClass))
+    {
+        return Infos[*Id];
+    }
+
+    if (!CanRegister(DamageTypeClass))
+    {
+        FDG_DamageTypeInfo Info;
+        Info.Traits = GetTraits(DamageTypeClass);
+        return Info;
+    }
+
+    return Register(DamageTypeClass);
+}
+
+const UClass* FDG_DamageTypeRegistry::GetClass(uint16 Id) const
+{
+    return Classes.IsValidIndex(Id) ? Classes[Id].Get() : nullptr;
+}
+
+FDG_DamageTypeInfo FDG_DamageTypeRegistry::Register(const UClass* DamageTypeClass)
+{
+    check(IsInGameThread());
+
+    if (!ensureMsgf(Infos.Num() <= MAX_uint16, TEXT("Too many damage types to register %s."), *DamageTypeClass->GetName()))
+    {
+        return Infos[0];
+    }
+
+    FDG_DamageTypeInfo Info;
+    Info.Id = static_cast<uint16>(Infos.Num());
+    Info.Traits = GetTraits(DamageTypeClass);
+
+    Infos.Add(Info);
+    Classes.Add(DamageTypeClass);
+    ClassIds.Add(DamageTypeClass, Info.Id);
+
+    return Info;
+}
+
+bool FDG_DamageTypeRegistry::CanRegister(const UClass* DamageTypeClass)
+{
+    if (DamageTypeClass->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+    {
+        return false;
+    }
+
+    const FString Name = DamageTypeClass->GetName();
+    return !Name.StartsWith(TEXT("SKEL_")) && !Name.StartsWith(TEXT("REINST_"));
+}
+
+EDG_DamageTypeTraits FDG_DamageTypeRegistry::GetTraits(const UClass* DamageTypeClass)
+{
+    if (const UDG_DamageType* DamageType = Cast<UDG_DamageType>(DamageTypeClass->GetDefaultObject()))
+    {
+        return DamageType->GetTraits();
+    }
+
+    return EDG_DamageTypeTraits::None;
+}
+
+void FDG_DamageTypeRegistry::RefreshTraits()
+{
+    check(IsInGameThread());
+
+    for (int32 Id = 1; Id < Infos.Num(); ++Id)
+    {
+        if (const UClass* DamageTypeClass = Classes[Id].Get())
+        {
+            Infos[Id].Traits = GetTraits(DamageTypeClass);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UDamageType;
+
+// Traits of a damage type, precomputed by FDG_DamageTypeRegistry so they can be tested without walking the class hierarchy.
+enum class EDG_DamageTypeTraits : uint32
+{
+    None = 0,
+
+    // Routed to the healing logic instead of the damage logic.
+    Heal = 1 << 0,
+
+    // Damage over time, heal over time, etc.
+    Periodic = 1 << 1,
+
+    // Should not be reduced by mitigation.
+    TrueDamage = 1 << 2,
+
+    IgnoresShields = 1 << 3,
+};
+ENUM_CLASS_FLAGS(EDG_DamageTypeTraits);
+
+struct FDG_DamageTypeInfo
+{
+    // Dense id, 0 is reserved for "no damage type".
+    uint16 Id = 0;
+
+    EDG_DamageTypeTraits Traits = EDG_DamageTypeTraits::None;
+};
+
+// Assigns every concrete UDamageType subclass a dense id and a trait mask.
+// All native classes are registered once the engine is initialized, classes loaded later (ie: blueprints) are registered the first time they are seen.
+// In the editor the traits are read again whenever a blueprint is compiled.
+// Game thread only.
+class HEALTHCOMPONENT_API FDG_DamageTypeRegistry
+{
+public:
+    static FDG_DamageTypeRegistry& Get();
+
+    // Registers every loaded UDamageType subclass.
+    void Initialize();
+
+    void Shutdown();
+
+    // Returns the info for the class of DamageType. Null is valid and returns id 0 with no traits.
+    FDG_DamageTypeInfo Find(const UDamageType* DamageType);
+
+    FDG_DamageTypeInfo Find(const UClass* DamageTypeClass);
+
+    // Returns the class registered with Id, or null for 0 and unknown ids.
+    const UClass* GetClass(uint16 Id) const;
+
+    int32 Num() const { return Infos.Num(); }
+
+private:
+    FDG_DamageTypeRegistry();
+
+    FDG_DamageTypeInfo Register(const UClass* DamageTypeClass);
+
+    // Abstract, deprecated and stale classes (ie: SKEL_ and REINST_ blueprint classes) never get an id.
+    static bool CanRegister(const UClass* DamageTypeClass);
+
+    static EDG_DamageTypeTraits GetTraits(const UClass* DamageTypeClass);
+
+    // Reads the traits of every registered class from its current class default object.
+    void RefreshTraits();
+
+    // Indexed by id.
+    TArray<FDG_DamageTypeInfo> Infos;
+
+    // Indexed by id.
+    TArray<TWeakObjectPtr<const UClass>> Classes;
+
+    TMap<TObjectKey<UClass>, uint16> ClassIds;
+
+    FDelegateHandle BlueprintCompiledHandle;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include "DeathEvent.generated.h"
+
+USTRUCT(BlueprintType)
+struct HEALTHCOMPONENT_API FDG_KillCredit
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    TWeakObjectPtr<AActor> Actor;
+
+    // Damage dealt (or healing done to the killer) within the assist window, after decay.
+    UPROPERTY(BlueprintReadOnly)
+    double Amount = 0.0;
+
+    // Amount relative to all credits, 0 to 1.
+    UPROPERTY(BlueprintReadOnly)
+    float Share = 0.f;
+
+    UPROPERTY(BlueprintReadOnly)
+    bool bKiller = false;
+
+    // Credited for healing the killer rather than damaging the victim.
+    UPROPERTY(BlueprintReadOnly)
+    bool bHealer = false;
+};
+
+USTRUCT(BlueprintType)
+struct HEALTHCOMPONENT_API FDG_DeathEvent
+{
+    GENERATED_BODY()
+
+    // The actor that dealt the killing blow, if any.
+    UPROPERTY(BlueprintReadOnly)
+    TWeakObjectPtr<AActor> Killer;
+
+    // Killer and assists, highest share first.
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FDG_KillCredit> Credits;
+};
@@ -19,6 +19,12 @@ public:
     
     }
 
+    FDG_HealEvent(double Heal, const UDamageType* DamageType, const FDG_DamageTypeInfo& DamageTypeInfo)
+        : FDG_DamageEvent(Heal, DamageType, DamageTypeInfo)
+    {
+
+    }
+
     double GetInitialHeal() const { return GetInitialDamage(); }
 
     double GetFinalHeal() const { return GetFinalDamage(); }
@@ -0,0 +1,246 @@
+#include "HealthDevTools.h"
+
+#if DG_HEALTH_DEV_TOOLS
+
+#include "HealthComponent.h"
+#include "HealthCore.h"
+#include "HitNumbers.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+// Helpers for the DG.Health.Benchmark commands, a friend of UDG_HealthComponent to turn its runtime features on.
+struct FDG_HealthBenchmarks
+{
+    template<typename ComponentType = UDG_HealthComponent>
+    static AActor* SpawnHealthActor(UWorld* World)
+    {
+        AActor* Actor = World->SpawnActor<AActor>();
+        ComponentType* HealthComponent = NewObject<ComponentType>(Actor);
+        HealthComponent->RegisterComponent();
+        return Actor;
+    }
+
+    static double SecondsSince(uint64 StartCycles)
+    {
+        return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+    }
+
+    // Threat and attribution are runtime options on top of their policies, enable them so their rows measure the work and not only the checks.
+    static void EnableFeatures(UDG_HealthComponent& HealthComponent, UDG_HitNumberSubsystem* HitNumberSubsystem)
+    {
+        HealthComponent.bThreatEnabled = true;
+        HealthComponent.bAttributionEnabled = true;
+        HealthComponent.bSendHitNumbers = HitNumberSubsystem != nullptr;
+        HealthComponent.HitNumberSubsystem = HitNumberSubsystem;
+
+        // Regen only costs something on death and revive, see MeasureDeaths.
+        HealthComponent.SetHealthRegen(1.0);
+        HealthComponent.SetHealthRegenRate(1.f);
+    }
+
+    // Runs Count non lethal hits through the pipeline compiled with PolicyType and returns the cost of one hit in nanoseconds.
+    template<typename PolicyType, typename ComponentType = UDG_HealthComponent>
+    static double MeasureHits(ComponentType& HealthComponent, TArrayView<AActor* const> Causers, int32 Count)
+    {
+        const UDamageType* DamageType = GetDefault<UDG_DamageType>();
+
+        // Enough health that no hit kills the target.
+        HealthComponent.SetMaxHealth(Count * 2.0);
+        HealthComponent.ResetHealth();
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            TDG_HealthCore<PolicyType, ComponentType>::HandleOwnerTakeDamage(HealthComponent, 1.f, DamageType, nullptr, Causers[Index % Causers.Num()]);
+        }
+
+        return SecondsSince(StartCycles) * 1000000000.0 / Count;
+    }
+
+    // Runs Count lethal hits each followed by a revive and returns the cost of one cycle in nanoseconds.
+    // This is where regen (stop and restart) and attribution (the death event) do their work.
+    template<typename PolicyType, typename ComponentType = UDG_HealthComponent>
+    static double MeasureDeaths(ComponentType& HealthComponent, TArrayView<AActor* const> Causers, int32 Count)
+    {
+        const UDamageType* DamageType = GetDefault<UDG_DamageType>();
+
+        HealthComponent.SetMaxHealth(100.0);
+        HealthComponent.ResetHealth();
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            TDG_HealthCore<PolicyType, ComponentType>::HandleOwnerTakeDamage(HealthComponent, static_cast<float>(HealthComponent.GetMaxHealth()), DamageType, nullptr, Causers[Index % Causers.Num()]);
+            TDG_HealthCore<PolicyType, ComponentType>::SetCurrentHealth(HealthComponent, HealthComponent.GetMaxHealth());
+        }
+
+        return SecondsSince(StartCycles) * 1000000000.0 / Count;
+    }
+
+    static void LogRow(const TCHAR* Name, double Value, double Baseline)
+    {
+        UE_LOG(LogHealthComponent, Log, TEXT("  %-30s %8.1f (%+.1f)"), Name, Value, Value - Baseline);
+    }
+};
+
+// Compares spawning an actor with a health component (register + BeginPlay) against
+// returning a pooled one to service (Deactivate + ResetHealth + Activate).
+static FAutoConsoleCommandWithWorldAndArgs DG_HealthBenchmarkPoolCommand(
+    TEXT("DG.Health.Benchmark.Pool"),
+    TEXT("Compare spawning health components with reusing them. Usage: DG.Health.Benchmark.Pool [Count]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (!World)
+        {
+            return;
+        }
+
+        const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+
+        TArray<AActor*> Actors;
+        Actors.Reserve(Count);
+
+        uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            Actors.Add(FDG_HealthBenchmarks::SpawnHealthActor(World));
+        }
+        const double SpawnSeconds = FDG_HealthBenchmarks::SecondsSince(StartCycles);
+
+        TArray<UDG_HealthComponent*> HealthComponents;
+        HealthComponents.Reserve(Count);
+        for (AActor* Actor : Actors)
+        {
+            UDG_HealthComponent* HealthComponent = Actor->FindComponentByClass<UDG_HealthComponent>();
+            HealthComponent->ApplyDamage(HealthComponent->GetMaxHealth() * 0.5);
+            HealthComponents.Add(HealthComponent);
+        }
+
+        StartCycles = FPlatformTime::Cycles64();
+        for (UDG_HealthComponent* HealthComponent : HealthComponents)
+        {
+            HealthComponent->Deactivate();
+            HealthComponent->Activate(true);
+        }
+        const double ReuseSeconds = FDG_HealthBenchmarks::SecondsSince(StartCycles);
+
+        // Activate(true) already reset them, damage them again so the bulk reset has the same work to do.
+        for (UDG_HealthComponent* HealthComponent : HealthComponents)
+        {
+            HealthComponent->ApplyDamage(HealthComponent->GetMaxHealth() * 0.5);
+        }
+
+        StartCycles = FPlatformTime::Cycles64();
+        UDG_HealthComponent::ResetHealthComponents(HealthComponents);
+        const double BulkResetSeconds = FDG_HealthBenchmarks::SecondsSince(StartCycles);
+
+        for (AActor* Actor : Actors)
+        {
+            Actor->Destroy();
+        }
+
+        UE_LOG(LogHealthComponent, Log, TEXT("Health pool benchmark (%d): spawn %.3f us, deactivate + activate(reset) %.3f us, bulk reset %.3f us per component."),
+            Count, SpawnSeconds * 1000000.0 / Count, ReuseSeconds * 1000000.0 / Count, BulkResetSeconds * 1000000.0 / Count);
+    }));
+
+// Per hit and per death cost of each compile time feature, measured on its own on top of the lite policy on the same component.
+// The replication rows need a server world (ie: a listen server PIE session), they are skipped otherwise.
+static FAutoConsoleCommandWithWorldAndArgs DG_HealthBenchmarkHitCommand(
+    TEXT("DG.Health.Benchmark.Hit"),
+    TEXT("Measure the per hit and per death cost of each health feature policy. Usage: DG.Health.Benchmark.Hit [Count]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (!World)
+        {
+            return;
+        }
+
+        const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+
+        const bool bServer = World->GetNetMode() == NM_ListenServer || World->GetNetMode() == NM_DedicatedServer;
+        if (!bServer)
+        {
+            UE_LOG(LogHealthComponent, Warning, TEXT("Health hit benchmark: not a server world, the replication rows are skipped."));
+        }
+
+        AActor* Target = FDG_HealthBenchmarks::SpawnHealthActor(World);
+        UDG_HealthComponent* HealthComponent = Target->FindComponentByClass<UDG_HealthComponent>();
+        FDG_HealthBenchmarks::EnableFeatures(*HealthComponent, bServer ? World->GetSubsystem<UDG_HitNumberSubsystem>() : nullptr);
+
+        AActor* LiteTarget = FDG_HealthBenchmarks::SpawnHealthActor<UDG_HealthComponent_Lite>(World);
+        UDG_HealthComponent_Lite* LiteHealthComponent = LiteTarget->FindComponentByClass<UDG_HealthComponent_Lite>();
+
+        // Owned by a player so hit numbers are queued for a connection.
+        APlayerController* PlayerController = World->GetFirstPlayerController();
+
+        TArray<AActor*> Causers;
+        for (int32 Index = 0; Index < 8; ++Index)
+        {
+            AActor* Causer = World->SpawnActor<AActor>();
+            Causer->SetOwner(PlayerController);
+            Causers.Add(Causer);
+        }
+
+        using FLogging = TDG_HealthPolicy<true, false, false, false, false, false>;
+        using FLoggingReplication = TDG_HealthPolicy<true, false, false, false, true, false>;
+        using FRegen = TDG_HealthPolicy<false, true, false, false, false, false>;
+        using FMitigation = TDG_HealthPolicy<false, false, true, false, false, false>;
+        using FStaticEvents = TDG_HealthPolicy<false, false, false, true, false, false>;
+        using FAttribution = TDG_HealthPolicy<false, false, false, false, false, true>;
+
+        {
+            const double LiteComponent = FDG_HealthBenchmarks::MeasureHits<FDG_HealthPolicy_Lite>(*LiteHealthComponent, Causers, Count);
+            const double Lite = FDG_HealthBenchmarks::MeasureHits<FDG_HealthPolicy_Lite>(*HealthComponent, Causers, Count);
+            const double Logging = FDG_HealthBenchmarks::MeasureHits<FLogging>(*HealthComponent, Causers, Count);
+            const double LoggingReplication = bServer ? FDG_HealthBenchmarks::MeasureHits<FLoggingReplication>(*HealthComponent, Causers, Count) : 0.0;
+            const double Regen = FDG_HealthBenchmarks::MeasureHits<FRegen>(*HealthComponent, Causers, Count);
+            const double Mitigation = FDG_HealthBenchmarks::MeasureHits<FMitigation>(*HealthComponent, Causers, Count);
+            const double StaticEvents = FDG_HealthBenchmarks::MeasureHits<FStaticEvents>(*HealthComponent, Causers, Count);
+            const double Attribution = FDG_HealthBenchmarks::MeasureHits<FAttribution>(*HealthComponent, Causers, Count);
+            const double Full = FDG_HealthBenchmarks::MeasureHits<FDG_HealthPolicy_Full>(*HealthComponent, Causers, Count);
+
+            UE_LOG(LogHealthComponent, Log, TEXT("Health hit benchmark (%d hits), ns per hit:"), Count);
+            FDG_HealthBenchmarks::LogRow(TEXT("UDG_HealthComponent_Lite"), LiteComponent, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("Lite"), Lite, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Logging + Threat"), Logging, Lite);
+            if (bServer)
+            {
+                FDG_HealthBenchmarks::LogRow(TEXT("+ Logging + Threat + Replication"), LoggingReplication, Lite);
+            }
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Regen"), Regen, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Mitigation"), Mitigation, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Static Events"), StaticEvents, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Attribution"), Attribution, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("Full"), Full, Lite);
+        }
+
+        // Deaths are much rarer than hits, measure fewer of them.
+        const int32 NumDeaths = FMath::Max(Count / 10, 1);
+        {
+            const double LiteComponent = FDG_HealthBenchmarks::MeasureDeaths<FDG_HealthPolicy_Lite>(*LiteHealthComponent, Causers, NumDeaths);
+            const double Lite = FDG_HealthBenchmarks::MeasureDeaths<FDG_HealthPolicy_Lite>(*HealthComponent, Causers, NumDeaths);
+            const double Regen = FDG_HealthBenchmarks::MeasureDeaths<FRegen>(*HealthComponent, Causers, NumDeaths);
+            const double StaticEvents = FDG_HealthBenchmarks::MeasureDeaths<FStaticEvents>(*HealthComponent, Causers, NumDeaths);
+            const double Attribution = FDG_HealthBenchmarks::MeasureDeaths<FAttribution>(*HealthComponent, Causers, NumDeaths);
+            const double Full = FDG_HealthBenchmarks::MeasureDeaths<FDG_HealthPolicy_Full>(*HealthComponent, Causers, NumDeaths);
+
+            UE_LOG(LogHealthComponent, Log, TEXT("Health death benchmark (%d deaths), ns per lethal hit + revive:"), NumDeaths);
+            FDG_HealthBenchmarks::LogRow(TEXT("UDG_HealthComponent_Lite"), LiteComponent, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("Lite"), Lite, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Regen"), Regen, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Static Events"), StaticEvents, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("+ Attribution"), Attribution, Lite);
+            FDG_HealthBenchmarks::LogRow(TEXT("Full"), Full, Lite);
+        }
+
+        Target->Destroy();
+        LiteTarget->Destroy();
+        for (AActor* Causer : Causers)
+        {
+            Causer->Destroy();
+        }
+    }));
+
+#endif // DG_HEALTH_DEV_TOOLS
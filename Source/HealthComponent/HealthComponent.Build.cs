@@ -36,11 +36,18 @@ public class HealthComponent : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"Json",
 				"Slate",
 				"SlateCore",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// The replication load test launches PIE from an automation test.
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
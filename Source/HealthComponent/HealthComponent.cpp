@@ -1,16 +1,26 @@
 #include "HealthComponent.h"
+#include "DamageTypeRegistry.h"
+#include "Misc/CoreDelegates.h"
 
 #define LOCTEXT_NAMESPACE "FHealthComponentModule"
 
 void FHealthComponentModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// Register every native damage type up front so the first hit of each type doesn't pay for it.
+	PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([]()
+	{
+		FDG_DamageTypeRegistry::Get().Initialize();
+	});
 }
 
 void FHealthComponentModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	FDG_DamageTypeRegistry::Get().Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -19,8 +29,11 @@ IMPLEMENT_MODULE(FHealthComponentModule, HealthComponent)
 
 
 #include "Net/UnrealNetwork.h"
-#include "DamageEvent.h"
-#include "HealEvent.h"
+#include "HealthCore.h"
+#include "HealthReplicationStats.h"
+#include "HitNumbers.h"
+
+DEFINE_LOG_CATEGORY(LogHealthComponent);
 
 TMulticastDelegate<void(UDG_HealthComponent*, const FDG_DamageEvent&)> UDG_HealthComponent::OnTakeDamage_Static;
 
@@ -33,7 +46,8 @@ TMulticastDelegate<void(UDG_HealthComponent*)> UDG_HealthComponent::OnRevive_Sta
 UDG_HealthComponent::UDG_HealthComponent(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
 {
-    
+    // Regen and log replication only run while active, see Activate/Deactivate.
+    bAutoActivate = true;
 }
 
 void UDG_HealthComponent::BeginPlay()
@@ -43,75 +57,135 @@ void UDG_HealthComponent::BeginPlay()
     DamageLog.Reserve(LogSize);
     HealingLog.Reserve(LogSize);
 
-    if (GetOwner()->HasAuthority())
-    {
-        // Don't use SetCurrentHealth here as it will trigger Revive.
-        CurrentHealth = MaxHealth;
-
-        GetOwner()->OnTakeAnyDamage.AddDynamic(this, &UDG_HealthComponent::HandleOwnerTakeDamage);
+    ThreatIndex.Configure(ThreatTopK, ThreatHalfLife);
+    DamageContributions.Configure(AssistWindow, AssistHalfLife);
+    HealingContributions.Configure(AssistWindow, AssistHalfLife);
 
-        StartHealthRegen();
-    }
+    TDG_HealthCore<FDG_HealthPolicy_Full>::BeginPlay(*this);
 
-    if (IsServer())
+    if (IsActive())
     {
-        BeginReplicatingLogs();
+        ResumeHealthProcessing();
     }
 }
 
-void UDG_HealthComponent::ApplyDamage(double Damage)
+void UDG_HealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    if (Damage > 0.0)
+    if (SignificanceIndex != INDEX_NONE)
     {
-        SetCurrentHealth(CurrentHealth - Damage);
+        if (UDG_HealthSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UDG_HealthSignificanceSubsystem>())
+        {
+            SignificanceSubsystem->Unregister(this);
+        }
     }
+
+    Super::EndPlay(EndPlayReason);
 }
 
-void UDG_HealthComponent::ApplyHeal(double Heal)
+void UDG_HealthComponent::Activate(bool bReset)
 {
-    if (Heal > 0.0)
+    const bool bWasActive = IsActive();
+
+    Super::Activate(bReset);
+
+    // Auto activation happens before BeginPlay, which resumes processing itself.
+    if (!HasBegunPlay() || !IsActive())
+    {
+        return;
+    }
+
+    if (bReset)
     {
-        SetCurrentHealth(CurrentHealth + Heal);
+        ResetHealth();
+    }
+
+    if (!bWasActive)
+    {
+        ResumeHealthProcessing();
     }
 }
 
-void UDG_HealthComponent::SetCurrentHealth(double NewHealth)
+void UDG_HealthComponent::Deactivate()
 {
-    NewHealth = FMath::Clamp(NewHealth, 0.0, MaxHealth);
+    const bool bWasActive = IsActive();
 
-    if (CurrentHealth != NewHealth)
+    Super::Deactivate();
+
+    if (HasBegunPlay() && bWasActive && !IsActive())
     {
-        auto PreviousHealth = CurrentHealth;
+        SuspendHealthProcessing();
+    }
+}
 
-        CurrentHealth = NewHealth;
-        OnHealthChanged.Broadcast(this);
+void UDG_HealthComponent::ResetHealth()
+{
+    DG_HEALTH_CAPTURE_RECORD(RecordInput(this, EDG_DamageCaptureRecordKind::Reset));
 
-        if (CurrentHealth == 0.0)
+    if (GetOwner()->HasAuthority())
+    {
+        // Don't use SetCurrentHealth here as it will trigger Revive.
+        if (CurrentHealth != MaxHealth)
         {
-            Die();
+            CurrentHealth = MaxHealth;
+            BroadcastHealthChanged();
         }
-        else if (PreviousHealth == 0.0 && CurrentHealth > 0.0)
+
+        // Regen is stopped on death.
+        if (IsActive())
         {
-            Revive();
+            StartHealthRegen();
         }
     }
+
+    ClearLogs();
+    ClearThreat();
+
+    DamageContributions.Reset();
+    HealingContributions.Reset();
+    DeathEvent = FDG_DeathEvent();
 }
 
-void UDG_HealthComponent::SetMaxHealth(double NewMaxHealth)
+void UDG_HealthComponent::ResetHealthComponents(TArrayView<UDG_HealthComponent* const> HealthComponents)
 {
-    if (MaxHealth != NewMaxHealth)
+    for (UDG_HealthComponent* HealthComponent : HealthComponents)
     {
-        MaxHealth = NewMaxHealth;
-        OnHealthChanged.Broadcast(this);
+        if (HealthComponent)
+        {
+            HealthComponent->ResetHealth();
+        }
     }
 }
 
+void UDG_HealthComponent::ApplyDamage(double Damage)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Full>::ApplyDamage(*this, Damage);
+}
+
+void UDG_HealthComponent::ApplyHeal(double Heal)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Full>::ApplyHeal(*this, Heal);
+}
+
+void UDG_HealthComponent::SetCurrentHealth(double NewHealth)
+{
+    DG_HEALTH_CAPTURE_RECORD(RecordSetHealth(this, NewHealth));
+
+    TDG_HealthCore<FDG_HealthPolicy_Full>::SetCurrentHealth(*this, NewHealth);
+}
+
+void UDG_HealthComponent::SetMaxHealth(double NewMaxHealth)
+{
+    DG_HEALTH_CAPTURE_RECORD(RecordSetMaxHealth(this, NewMaxHealth));
+
+    TDG_HealthCore<FDG_HealthPolicy_Full>::SetMaxHealth(*this, NewMaxHealth);
+}
+
 void UDG_HealthComponent::SetHealthRegen(double NewHealthRegen)
 {
     if (HealthRegen != NewHealthRegen)
     {
         HealthRegen = NewHealthRegen;
-        OnHealthChanged.Broadcast(this);
+        BroadcastHealthChanged();
     }
 }
 
@@ -123,14 +197,13 @@ void UDG_HealthComponent::SetHealthRegenRate(float NewHealthRegenRate)
 
         StartHealthRegen();
 
-        OnHealthChanged.Broadcast(this);
+        BroadcastHealthChanged();
     }
 }
 
 float UDG_HealthComponent::GetCurrentHealthNormalized() const
 {
-    check(MaxHealth != 0);
-    return CurrentHealth / MaxHealth;
+    return TDG_HealthCore<FDG_HealthPolicy_Full>::GetCurrentHealthNormalized(*this);
 }
 
 double UDG_HealthComponent::GetHealthRegenNormalized() const
@@ -147,6 +220,8 @@ void UDG_HealthComponent::ClearLogs()
 
 void UDG_HealthComponent::ClearDamageLog()
 {
+    DG_HEALTH_CAPTURE_RECORD(RecordInput(this, EDG_DamageCaptureRecordKind::ClearDamageLog));
+
     DamageLog.Reset(LogSize);
 
     if (IsServer())
@@ -162,6 +237,8 @@ void UDG_HealthComponent::ClearDamageLog()
 
 void UDG_HealthComponent::ClearHealingLog()
 {
+    DG_HEALTH_CAPTURE_RECORD(RecordInput(this, EDG_DamageCaptureRecordKind::ClearHealingLog));
+
     HealingLog.Reset(LogSize);
 
     if (IsServer())
@@ -175,34 +252,91 @@ void UDG_HealthComponent::ClearHealingLog()
     }
 }
 
-void UDG_HealthComponent::HandleOwnerTakeDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+void UDG_HealthComponent::SetHealthLOD(EDG_HealthLOD NewHealthLOD)
 {
-    if (DamageType->IsA<UDG_DamageType_Heal>())
+    if (HealthLOD == NewHealthLOD)
     {
-        FDG_HealEvent HealEvent = FDG_HealEvent(Damage, DamageType);
-        if (HandleReceiveHeal(HealEvent))
-        {
-            AddActorToHealLog(DamageCauser, HealEvent);
-        }
+        return;
+    }
+
+    DG_HEALTH_CAPTURE_RECORD(RecordSetLOD(this, static_cast<uint8>(NewHealthLOD)));
+
+    FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+    if (TimerManager.IsTimerActive(TimerHandle_HealthRegen))
+    {
+        // Credit the part of the current interval that already elapsed, then restart with the new interval.
+        const float Elapsed = TimerManager.GetTimerElapsed(TimerHandle_HealthRegen);
+        HealthLOD = NewHealthLOD;
+
+        TimerManager.SetTimer(TimerHandle_HealthRegen, this, &UDG_HealthComponent::HandleHealthRegen, HealthRegenRate * GetRegenIntervalScale(), true);
+        ApplyHealthRegen(HealthRegen * Elapsed / HealthRegenRate);
     }
     else
     {
-        FDG_DamageEvent DamageEvent = FDG_DamageEvent(Damage, DamageType);
-        if (HandleTakeDamage(DamageEvent))
-        {
-            AddActorToDamageLog(DamageCauser, DamageEvent);
-        }
+        HealthLOD = NewHealthLOD;
     }
+
+    if (HealthLOD == EDG_HealthLOD::Full)
+    {
+        FlushHealthChanged();
+    }
+}
+
+void UDG_HealthComponent::FlushHealthChanged()
+{
+    if (bHealthChangedPending)
+    {
+        bHealthChangedPending = false;
+
+        DG_HEALTH_CAPTURE_STAGE(true);
+        OnHealthChanged.Broadcast(this);
+    }
+}
+
+void UDG_HealthComponent::GetTopThreats(int32 K, TArray<FDG_ThreatEntry>& OutEntries) const
+{
+    ThreatIndex.GetTop(K, GetWorld()->GetTimeSeconds(), OutEntries);
+}
+
+double UDG_HealthComponent::GetThreat(const AActor* Actor) const
+{
+    return ThreatIndex.GetThreat(Actor, GetWorld()->GetTimeSeconds());
+}
+
+void UDG_HealthComponent::RemoveThreat(const AActor* Actor)
+{
+    if (ThreatIndex.Remove(Actor))
+    {
+        OnThreatChanged.Broadcast(this);
+    }
+}
+
+void UDG_HealthComponent::ClearThreat()
+{
+    if (ThreatIndex.Num() > 0)
+    {
+        ThreatIndex.Reset();
+        OnThreatChanged.Broadcast(this);
+    }
+}
+
+void UDG_HealthComponent::HandleOwnerTakeDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Full>::HandleOwnerTakeDamage(*this, Damage, DamageType, InstigatedBy, DamageCauser);
 }
 
 bool UDG_HealthComponent::HandleTakeDamage(FDG_DamageEvent& DamageEvent)
 {
-    ApplyDamageMitigation(DamageEvent);
-    return ApplyFinalDamage(DamageEvent);
+    return TDG_HealthCore<FDG_HealthPolicy_Full>::HandleTakeDamage(*this, DamageEvent);
 }
 
 bool UDG_HealthComponent::ApplyDamageMitigation(FDG_DamageEvent& DamageEvent)
 {
+    if (DamageEvent.HasDamageTypeTrait(EDG_DamageTypeTraits::TrueDamage))
+    {
+        return false;
+    }
+
     if (false /*We only broadcast if modified*/)
     {
         DamageEvent.ModifyDamage(DamageEvent.GetInitialDamage());
@@ -215,21 +349,12 @@ bool UDG_HealthComponent::ApplyDamageMitigation(FDG_DamageEvent& DamageEvent)
 
 bool UDG_HealthComponent::ApplyFinalDamage(FDG_DamageEvent& DamageEvent)
 {
-    const double FinalDamage = DamageEvent.GetFinalDamage();
-    if (FinalDamage > 0.0)
-    {
-        ApplyDamage(FinalDamage);
-        OnTakeDamage.Broadcast(this, DamageEvent);
-        OnTakeDamage_Static.Broadcast(this, DamageEvent);
-        return true;
-    }
-    return false;
+    return TDG_HealthCore<FDG_HealthPolicy_Full>::ApplyFinalDamage(*this, DamageEvent);
 }
 
 bool UDG_HealthComponent::HandleReceiveHeal(FDG_HealEvent& HealEvent)
 {
-    ApplyHealAmplification(HealEvent);
-    return ApplyFinalHeal(HealEvent);
+    return TDG_HealthCore<FDG_HealthPolicy_Full>::HandleReceiveHeal(*this, HealEvent);
 }
 
 bool UDG_HealthComponent::ApplyHealAmplification(FDG_HealEvent& HealEvent)
@@ -245,41 +370,76 @@ bool UDG_HealthComponent::ApplyHealAmplification(FDG_HealEvent& HealEvent)
 
 bool UDG_HealthComponent::ApplyFinalHeal(FDG_HealEvent& HealEvent)
 {
-    const double FinalHeal = HealEvent.GetFinalHeal();
-    if (FinalHeal > 0.0)
-    {
-        ApplyHeal(FinalHeal);
-        OnReceiveHeal.Broadcast(this, HealEvent);
-        OnReceiveHeal_Static.Broadcast(this, HealEvent);
-        return true;
-    }
-    return false;
+    return TDG_HealthCore<FDG_HealthPolicy_Full>::ApplyFinalHeal(*this, HealEvent);
 }
 
 void UDG_HealthComponent::Die()
 {
-    if (IsDead())
+    TDG_HealthCore<FDG_HealthPolicy_Full>::Die(*this);
+}
+
+void UDG_HealthComponent::BuildDeathEvent(FDG_DeathEvent& OutDeathEvent) const
+{
+    AActor* Killer = CurrentInstigator;
+
+    OutDeathEvent.Killer = Killer;
+    OutDeathEvent.Credits.Reset();
+
+    const double Time = GetWorld()->GetTimeSeconds();
+    double TotalAmount = 0.0;
+
+    // A source can have damaged the victim and healed the killer, they only get one credit.
+    TMap<const AActor*, int32, TInlineSetAllocator<16>> CreditIndices;
+
+    DamageContributions.ForEachRecent(Time, [&OutDeathEvent, &TotalAmount, &CreditIndices, Killer](AActor* Actor, double Amount)
     {
-        return;
-    }
+        CreditIndices.Add(Actor, OutDeathEvent.Credits.Num());
 
-    StopHealthRegen();
+        FDG_KillCredit& Credit = OutDeathEvent.Credits.AddDefaulted_GetRef();
+        Credit.Actor = Actor;
+        Credit.Amount = Amount;
+        Credit.bKiller = Actor == Killer;
+        TotalAmount += Amount;
+    });
 
-    OnDeath.Broadcast(this);
-    OnDeath_Static.Broadcast(this);
-}
+    const UDG_HealthComponent* KillerHealthComponent = Killer ? Killer->FindComponentByClass<UDG_HealthComponent>() : nullptr;
+    if (KillerHealthComponent && HealerAssistWeight > 0.0)
+    {
+        KillerHealthComponent->HealingContributions.ForEachRecent(Time, [this, &OutDeathEvent, &TotalAmount, &CreditIndices, Killer](AActor* Actor, double Amount)
+        {
+            if (Actor == Killer)
+            {
+                return;
+            }
 
-void UDG_HealthComponent::Revive()
-{
-    if (!IsDead())
+            const int32& CreditIndex = CreditIndices.FindOrAdd(Actor, OutDeathEvent.Credits.Num());
+            if (CreditIndex == OutDeathEvent.Credits.Num())
+            {
+                OutDeathEvent.Credits.AddDefaulted_GetRef().Actor = Actor;
+            }
+
+            FDG_KillCredit& Credit = OutDeathEvent.Credits[CreditIndex];
+            const double WeightedAmount = Amount * HealerAssistWeight;
+            Credit.Amount += WeightedAmount;
+            Credit.bHealer = true;
+            TotalAmount += WeightedAmount;
+        });
+    }
+
+    if (TotalAmount > 0.0)
     {
-        return;
+        for (FDG_KillCredit& Credit : OutDeathEvent.Credits)
+        {
+            Credit.Share = static_cast<float>(Credit.Amount / TotalAmount);
+        }
     }
 
-    StartHealthRegen();
+    OutDeathEvent.Credits.Sort([](const FDG_KillCredit& A, const FDG_KillCredit& B) { return A.Amount > B.Amount; });
+}
 
-    OnRevive.Broadcast(this);
-    OnRevive_Static.Broadcast(this);
+void UDG_HealthComponent::Revive()
+{
+    TDG_HealthCore<FDG_HealthPolicy_Full>::Revive(*this);
 }
 
 void UDG_HealthComponent::StartHealthRegen()
@@ -292,30 +452,53 @@ void UDG_HealthComponent::StartHealthRegen()
             return;
         }
 
-        TimerManager.SetTimer(TimerHandle_HealthRegen, this, &UDG_HealthComponent::HandleHealthRegen, HealthRegenRate, true);
+        TimerManager.SetTimer(TimerHandle_HealthRegen, this, &UDG_HealthComponent::HandleHealthRegen, HealthRegenRate * GetRegenIntervalScale(), true);
         OnStartHealthRegen.Broadcast(this);
 
+        // The immediate tick isn't a scaled interval, it gets the plain amount.
         if (bRegenImmediately)
         {
-            HandleHealthRegen();
+            ApplyHealthRegen(HealthRegen);
         }
     }
 }
 
 void UDG_HealthComponent::HandleHealthRegen()
 {
-    if (HealthRegen > 0.0)
+    ApplyHealthRegen(HealthRegen * GetRegenIntervalScale());
+}
+
+void UDG_HealthComponent::ApplyHealthRegen(double Amount)
+{
+    if (Amount > 0.0)
     {
+        DG_HEALTH_CAPTURE_RECORD(RecordRegen(this, Amount));
+
         if (bRegenIsHealing)
         {
-            ApplyHeal(HealthRegen);
+            ApplyHeal(Amount);
         }
         else
         {
-            SetCurrentHealth(CurrentHealth + HealthRegen);
+            SetCurrentHealth(CurrentHealth + Amount);
         }
 
-        OnHealthRegen.Broadcast(this, HealthRegen);
+        DG_HEALTH_CAPTURE_STAGE(true);
+        OnHealthRegen.Broadcast(this, Amount);
+    }
+}
+
+float UDG_HealthComponent::GetRegenIntervalScale() const
+{
+    switch (HealthLOD)
+    {
+    // Also clamped here for values set from code, a scale below 1 would tick faster than at full LOD.
+    case EDG_HealthLOD::Reduced:
+        return FMath::Max(ReducedRegenIntervalScale, 1.f);
+    case EDG_HealthLOD::Minimal:
+        return FMath::Max(MinimalRegenIntervalScale, 1.f);
+    default:
+        return 1.f;
     }
 }
 
@@ -329,66 +512,86 @@ void UDG_HealthComponent::StopHealthRegen()
     }
 }
 
-void UDG_HealthComponent::AddActorToDamageLog(AActor* Actor, const FDG_DamageEvent& DamageEvent)
+void UDG_HealthComponent::ResumeHealthProcessing()
 {
-    const int32 Index = DamageLog.IndexOfByKey(FDG_HealthComponentLogItem(Actor));
-
-    if (Index != INDEX_NONE)
+    // Dead components regen again from Revive.
+    if (GetOwner()->HasAuthority() && !IsDead())
     {
-        auto Item = DamageLog[Index];
-        Item.Amount += DamageEvent.GetFinalDamage();
-        DamageLog.RemoveAt(Index, 1, false);
-        DamageLog.Insert(Item, 0);
+        StartHealthRegen();
     }
-    else
-    {
-        if (DamageLog.Num() == LogSize)
-        {
-            DamageLog.RemoveAt(LogSize - 1, 1, false);
-        }
 
-        DamageLog.Insert(FDG_HealthComponentLogItem(Actor, Actor ? GetActorName(Actor) : "Unknown", DamageEvent.GetFinalDamage()), 0);
-    }
-    
     if (IsServer())
     {
-        bDamageLogDirty = true;
+        BeginReplicatingLogs();
+
+        if (bSendHitNumbers)
+        {
+            HitNumberSubsystem = GetWorld()->GetSubsystem<UDG_HitNumberSubsystem>();
+        }
     }
-    else
+
+    if (bUseSignificance)
     {
-        OnDamageLogChanged.Broadcast(this);
+        if (UDG_HealthSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UDG_HealthSignificanceSubsystem>())
+        {
+            SignificanceSubsystem->Register(this);
+        }
     }
 }
 
-void UDG_HealthComponent::AddActorToHealLog(AActor* Actor, const FDG_HealEvent& HealEvent)
+void UDG_HealthComponent::SuspendHealthProcessing()
 {
-    const int32 Index = HealingLog.IndexOfByKey(Actor);
+    StopHealthRegen();
 
-    if (Index != INDEX_NONE)
+    if (IsServer())
     {
-        auto Item = HealingLog[Index];
-        Item.Amount += HealEvent.GetFinalHeal();
-        HealingLog.RemoveAt(Index, 1, false);
-        HealingLog.Insert(Item, 0);
+        // Send whatever changed before going quiet.
+        ReplicateLogs();
+        GetWorld()->GetTimerManager().ClearTimer(TimerHandle_ReplicateLogs);
     }
-    else
+
+    HitNumberSubsystem.Reset();
+
+    if (SignificanceIndex != INDEX_NONE)
     {
-        if (HealingLog.Num() == LogSize)
+        // The subsystem won't flush a coalesced OnHealthChanged once unregistered.
+        FlushHealthChanged();
+
+        if (UDG_HealthSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UDG_HealthSignificanceSubsystem>())
         {
-            HealingLog.RemoveAt(LogSize - 1, 1, false);
+            SignificanceSubsystem->Unregister(this);
         }
-
-        HealingLog.Insert(FDG_HealthComponentLogItem(Actor, Actor ? GetActorName(Actor) : "Unknown", HealEvent.GetFinalHeal()), 0);
     }
+}
 
-    if (IsServer())
+void UDG_HealthComponent::AddActorToDamageLog(AActor* Actor, const FDG_DamageEvent& DamageEvent)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Full>::AddActorToDamageLog(*this, Actor, DamageEvent);
+}
+
+void UDG_HealthComponent::AddActorToHealLog(AActor* Actor, const FDG_HealEvent& HealEvent)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Full>::AddActorToHealLog(*this, Actor, HealEvent);
+}
+
+void UDG_HealthComponent::AddThreat(AActor* Actor, double Amount)
+{
+    if (ThreatIndex.AddThreat(Actor, Amount, GetWorld()->GetTimeSeconds()))
     {
-        bHealingLogDirty = true;
+        OnThreatChanged.Broadcast(this);
     }
-    else
+}
+
+void UDG_HealthComponent::BroadcastHealthChanged()
+{
+    if (HealthLOD != EDG_HealthLOD::Full)
     {
-        OnHealingLogChanged.Broadcast(this);
+        bHealthChangedPending = true;
+        return;
     }
+
+    DG_HEALTH_CAPTURE_STAGE(true);
+    OnHealthChanged.Broadcast(this);
 }
 
 FString UDG_HealthComponent::GetActorName(AActor* Actor) const
@@ -411,7 +614,8 @@ void UDG_HealthComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 
 bool UDG_HealthComponent::IsServer() const
 {
-    return GetNetMode() == NM_DedicatedServer || GetNetMode() == NM_ListenServer;
+    const ENetMode NetMode = GetNetMode();
+    return NetMode == NM_DedicatedServer || NetMode == NM_ListenServer;
 }
 
 void UDG_HealthComponent::BeginReplicatingLogs()
@@ -421,27 +625,109 @@ void UDG_HealthComponent::BeginReplicatingLogs()
 
 void UDG_HealthComponent::ReplicateLogs()
 {
+    DG_HEALTH_STATS_SCOPE(ServerLogCopy);
+
     if (bDamageLogDirty)
     {
         ReplicatedDamageLog = DamageLog;
         bDamageLogDirty = false;
+
+#if DG_HEALTH_STATS
+        FDG_HealthReplicationStats::Get().AddLogCopy();
+#endif
     }
 
     if (bHealingLogDirty)
     {
         ReplicatedHealingLog = HealingLog;
         bHealingLogDirty = false;
+
+#if DG_HEALTH_STATS
+        FDG_HealthReplicationStats::Get().AddLogCopy();
+#endif
     }
 }
 
 void UDG_HealthComponent::OnRep_DamageLog()
 {
+    DG_HEALTH_STATS_SCOPE(ClientOnRep);
+
     DamageLog = ReplicatedDamageLog;
     OnDamageLogChanged.Broadcast(this);
 }
 
 void UDG_HealthComponent::OnRep_HealingLog()
 {
+    DG_HEALTH_STATS_SCOPE(ClientOnRep);
+
     HealingLog = ReplicatedHealingLog;
     OnHealingLogChanged.Broadcast(this);
 }
+
+UDG_HealthComponent_Lite::UDG_HealthComponent_Lite(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    bAutoActivate = true;
+}
+
+void UDG_HealthComponent_Lite::BeginPlay()
+{
+    Super::BeginPlay();
+
+    TDG_HealthCore<FDG_HealthPolicy_Lite, UDG_HealthComponent_Lite>::BeginPlay(*this);
+}
+
+void UDG_HealthComponent_Lite::Activate(bool bReset)
+{
+    Super::Activate(bReset);
+
+    if (bReset && HasBegunPlay() && IsActive())
+    {
+        ResetHealth();
+    }
+}
+
+void UDG_HealthComponent_Lite::ResetHealth()
+{
+    // Don't use SetCurrentHealth here as it will trigger Revive.
+    if (GetOwner()->HasAuthority() && CurrentHealth != MaxHealth)
+    {
+        CurrentHealth = MaxHealth;
+        BroadcastHealthChanged();
+    }
+}
+
+void UDG_HealthComponent_Lite::ApplyDamage(double Damage)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Lite, UDG_HealthComponent_Lite>::ApplyDamage(*this, Damage);
+}
+
+void UDG_HealthComponent_Lite::ApplyHeal(double Heal)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Lite, UDG_HealthComponent_Lite>::ApplyHeal(*this, Heal);
+}
+
+void UDG_HealthComponent_Lite::SetCurrentHealth(double NewHealth)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Lite, UDG_HealthComponent_Lite>::SetCurrentHealth(*this, NewHealth);
+}
+
+void UDG_HealthComponent_Lite::SetMaxHealth(double NewMaxHealth)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Lite, UDG_HealthComponent_Lite>::SetMaxHealth(*this, NewMaxHealth);
+}
+
+float UDG_HealthComponent_Lite::GetCurrentHealthNormalized() const
+{
+    return TDG_HealthCore<FDG_HealthPolicy_Lite, UDG_HealthComponent_Lite>::GetCurrentHealthNormalized(*this);
+}
+
+void UDG_HealthComponent_Lite::HandleOwnerTakeDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+{
+    TDG_HealthCore<FDG_HealthPolicy_Lite, UDG_HealthComponent_Lite>::HandleOwnerTakeDamage(*this, Damage, DamageType, InstigatedBy, DamageCauser);
+}
+
+void UDG_HealthComponent_Lite::BroadcastHealthChanged()
+{
+    OnHealthChanged.Broadcast(this);
+}
@@ -10,30 +10,63 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	FDelegateHandle PostEngineInitHandle;
 };
 
 #include "Components/ActorComponent.h"
 #include "HealthComponentLogItem.h"
+#include "ThreatIndex.h"
+#include "ContributionWindow.h"
+#include "DeathEvent.h"
+#include "HealthSignificance.h"
 #include "HealthComponent.generated.h"
 
+HEALTHCOMPONENT_API DECLARE_LOG_CATEGORY_EXTERN(LogHealthComponent, Log, All);
+
 struct FDG_DamageEvent;
 struct FDG_HealEvent;
 class AActor;
 class UDamageType;
 class AController;
+class UDG_HitNumberSubsystem;
 
 UCLASS(Blueprintable, BlueprintType, meta = (BlueprintSpawnableComponent))
 class HEALTHCOMPONENT_API UDG_HealthComponent : public UActorComponent
 {
     GENERATED_BODY()
 
+    friend class FDG_DamageCapture;
+    friend class FDG_DamageReplayer;
+    friend struct FDG_HealthBenchmarks;
+    friend class UDG_HealthSignificanceSubsystem;
+    template<typename PolicyType, typename ComponentType> friend struct TDG_HealthCore;
+
 public:
     UDG_HealthComponent(const FObjectInitializer& ObjectInitializer);
 
     // Begin ActorComponent Interface
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Resumes regen, log replication and significance. Activate(true) also calls ResetHealth.
+    virtual void Activate(bool bReset = false) override;
+
+    // Suspends regen, log replication and significance, and ignores damage until activated again.
+    // The OnTakeAnyDamage binding and log allocations are kept so pooled actors can be reused without BeginPlay.
+    virtual void Deactivate() override;
     // End ActorComponent Interface
 
+    // Begin Pooling
+    // Restores CurrentHealth to MaxHealth and clears logs, threat and attribution without freeing memory.
+    // Doesn't broadcast OnRevive.
+    UFUNCTION(BlueprintCallable)
+    void ResetHealth();
+
+    static void ResetHealthComponents(TArrayView<UDG_HealthComponent* const> HealthComponents);
+    // End Pooling
+
     // Begin State
     UFUNCTION(BlueprintCallable)
     void ApplyDamage(double Damage);
@@ -96,6 +129,35 @@ public:
     void ClearHealingLog();
     // End Logging
 
+    // Begin Threat
+    // Actor with the most threat, O(1).
+    AActor* GetTopThreat() const { return ThreatIndex.GetTop(); }
+
+    // The K actors with the most threat, highest first. O(K) when K <= ThreatTopK.
+    void GetTopThreats(int32 K, TArray<FDG_ThreatEntry>& OutEntries) const;
+
+    double GetThreat(const AActor* Actor) const;
+
+    void RemoveThreat(const AActor* Actor);
+
+    void ClearThreat();
+    // End Threat
+
+    // Begin Significance
+    UFUNCTION(BlueprintCallable)
+    EDG_HealthLOD GetHealthLOD() const { return HealthLOD; }
+
+    // Changes the processing tier. CurrentHealth is kept exactly as if the tier never changed.
+    // Normally driven by UDG_HealthSignificanceSubsystem when bUseSignificance is set.
+    void SetHealthLOD(EDG_HealthLOD NewHealthLOD);
+
+    // Broadcasts OnHealthChanged if a broadcast was coalesced while not at full LOD.
+    void FlushHealthChanged();
+    // End Significance
+
+    // Killer and assists of the last death. Filled before OnDeath is broadcast when bAttributionEnabled is set.
+    const FDG_DeathEvent& GetDeathEvent() const { return DeathEvent; }
+
 protected:
     // Begin Main Logic
     // Callback for Owner's OnTakeAnyDamage delegate.
@@ -121,6 +183,9 @@ protected:
     // End Healing Logic
 
     virtual void Die();
+
+    // Computes the killer and assists from the contribution windows in a single pass over recent sources.
+    virtual void BuildDeathEvent(FDG_DeathEvent& OutDeathEvent) const;
     
     virtual void Revive();
     // End Main Logic
@@ -130,25 +195,44 @@ protected:
     
     virtual void HandleHealthRegen();
 
+    // Applies Amount of regen to CurrentHealth and broadcasts OnHealthRegen.
+    void ApplyHealthRegen(double Amount);
+
+    // Regen interval and amount are both scaled by this at lower LODs so the total stays the same.
+    float GetRegenIntervalScale() const;
+
     virtual void StopHealthRegen();
     // End Regen Logic
 
+    // Begin Activation Logic
+    // Starts everything that runs while the component is active.
+    void ResumeHealthProcessing();
+
+    void SuspendHealthProcessing();
+    // End Activation Logic
+
     // Begin Logging Logic
     virtual void AddActorToDamageLog(AActor* Actor, const FDG_DamageEvent& DamageEvent);
     
     virtual void AddActorToHealLog(AActor* Actor, const FDG_HealEvent& HealEvent);
 
+    // Adds to the threat of Actor and broadcasts OnThreatChanged if the top ThreatTopK changed.
+    virtual void AddThreat(AActor* Actor, double Amount);
+
     // This is a helper function that can be used for adding names to the damage log.
     // This is what will show in that damage log.
     virtual FString GetActorName(AActor* Actor) const; 
     // End Logging Logic
 
+    // Broadcasts OnHealthChanged now at full LOD, otherwise on the next significance pass.
+    void BroadcastHealthChanged();
+
     // Begin Replication Logic
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
     bool IsServer() const;
 
-    void BeginReplicatingLogs();
+    virtual void BeginReplicatingLogs();
 
     void ReplicateLogs();
 
@@ -206,6 +290,9 @@ public:
 
     TMulticastDelegate<void(UDG_HealthComponent*)> OnHealingLogChanged;
 
+    // Called when the actors in the top ThreatTopK change, not when they only change order.
+    TMulticastDelegate<void(UDG_HealthComponent*)> OnThreatChanged;
+
 protected:
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     double CurrentHealth;
@@ -238,11 +325,77 @@ protected:
     UPROPERTY(EditInstanceOnly, Category="Logging")
     float LogReplicationRate = 0.5;
 
+    // Threat is accumulated by instigator from the damage log, and the healing log when HealingThreatMultiplier is set.
+    UPROPERTY(EditInstanceOnly, Category="Threat")
+    bool bThreatEnabled = false;
+
+    // Number of actors kept ranked for GetTopThreats and OnThreatChanged.
+    UPROPERTY(EditInstanceOnly, Category="Threat")
+    int32 ThreatTopK = 5;
+
+    // Time for threat to decay by half, 0 disables decay.
+    UPROPERTY(EditInstanceOnly, Category="Threat")
+    float ThreatHalfLife = 0.f;
+
+    // Threat generated per point of healing received.
+    UPROPERTY(EditInstanceOnly, Category="Threat")
+    double HealingThreatMultiplier = 0.0;
+
+    // Lets UDG_HealthSignificanceSubsystem lower the LOD of this component.
+    UPROPERTY(EditInstanceOnly, Category="Significance")
+    bool bUseSignificance = false;
+
+    UPROPERTY(EditInstanceOnly, Category="Significance", meta=(ClampMin="1"))
+    float ReducedRegenIntervalScale = 4.f;
+
+    UPROPERTY(EditInstanceOnly, Category="Significance", meta=(ClampMin="1"))
+    float MinimalRegenIntervalScale = 8.f;
+
+    // Sends merged damage and heal numbers to the clients owning this actor or the source of the hit, see UDG_HitNumberSubsystem.
+    UPROPERTY(EditInstanceOnly, Category="Replication")
+    bool bSendHitNumbers = false;
+
+    // Tracks time stamped damage and healing per source to credit kills and assists.
+    UPROPERTY(EditInstanceOnly, Category="Attribution")
+    bool bAttributionEnabled = false;
+
+    // Sources that contributed within this many seconds of the death are credited.
+    UPROPERTY(EditInstanceOnly, Category="Attribution")
+    float AssistWindow = 10.f;
+
+    // Time for a contribution to decay by half, 0 disables decay.
+    UPROPERTY(EditInstanceOnly, Category="Attribution")
+    float AssistHalfLife = 5.f;
+
+    // Weight of healing done to the killer relative to damage done to the victim.
+    UPROPERTY(EditInstanceOnly, Category="Attribution")
+    double HealerAssistWeight = 0.5;
+
     // Logging
     TArray<FDG_HealthComponentLogItem> DamageLog;
 
     TArray<FDG_HealthComponentLogItem> HealingLog;
 
+    FDG_ThreatIndex ThreatIndex;
+
+    // Significance
+    EDG_HealthLOD HealthLOD = EDG_HealthLOD::Full;
+
+    bool bHealthChangedPending = false;
+
+    // Index in UDG_HealthSignificanceSubsystem, INDEX_NONE when not registered.
+    int32 SignificanceIndex = INDEX_NONE;
+
+    // Attribution
+    FDG_ContributionWindow DamageContributions;
+
+    FDG_ContributionWindow HealingContributions;
+
+    FDG_DeathEvent DeathEvent;
+
+    // The instigating pawn (or controller, or DamageCauser when there is none) of the hit being handled, only set during HandleOwnerTakeDamage.
+    AActor* CurrentInstigator = nullptr;
+
     // The replication logic is separated because these arrays can change a lot between each frame
     UPROPERTY(ReplicatedUsing=OnRep_DamageLog)
     TArray<FDG_HealthComponentLogItem> ReplicatedDamageLog;
@@ -251,6 +404,9 @@ protected:
     UPROPERTY(ReplicatedUsing = OnRep_HealingLog)
     TArray<FDG_HealthComponentLogItem> ReplicatedHealingLog;
 
+    // Set on servers while active when bSendHitNumbers is set.
+    TWeakObjectPtr<UDG_HitNumberSubsystem> HitNumberSubsystem;
+
     // This is only used in multiplayer.
     bool bDamageLogDirty = false;
 
@@ -263,3 +419,84 @@ protected:
     FTimerHandle TimerHandle_ReplicateLogs;
     // End Timer Handles
 };
+
+// Health component without logging, regen, mitigation, static events, replication or attribution.
+// Use it for actors that only need health and the per instance delegates (ie: destructibles, projectiles).
+// It doesn't derive from UDG_HealthComponent so it carries none of that state, it isn't captured and doesn't use significance.
+UCLASS(Blueprintable, BlueprintType, meta = (BlueprintSpawnableComponent))
+class HEALTHCOMPONENT_API UDG_HealthComponent_Lite : public UActorComponent
+{
+    GENERATED_BODY()
+
+    template<typename PolicyType, typename ComponentType> friend struct TDG_HealthCore;
+
+public:
+    UDG_HealthComponent_Lite(const FObjectInitializer& ObjectInitializer);
+
+    // Begin ActorComponent Interface
+    virtual void BeginPlay() override;
+
+    // Activate(true) also calls ResetHealth. Damage is ignored while deactivated.
+    virtual void Activate(bool bReset = false) override;
+    // End ActorComponent Interface
+
+    // Restores CurrentHealth to MaxHealth. Doesn't broadcast OnRevive.
+    UFUNCTION(BlueprintCallable)
+    void ResetHealth();
+
+    // Begin State
+    UFUNCTION(BlueprintCallable)
+    void ApplyDamage(double Damage);
+
+    UFUNCTION(BlueprintCallable)
+    void ApplyHeal(double Heal);
+
+    UFUNCTION(BlueprintCallable)
+    bool IsDead() const { return CurrentHealth == 0.0; }
+    // End State
+
+    // Begin Setters
+    UFUNCTION(BlueprintCallable)
+    void SetCurrentHealth(double NewHealth);
+
+    UFUNCTION(BlueprintCallable)
+    void SetMaxHealth(double NewMaxHealth);
+    // End Setters
+
+    // Begin Getters
+    UFUNCTION(BlueprintCallable)
+    double GetCurrentHealth() const { return CurrentHealth; }
+
+    UFUNCTION(BlueprintCallable)
+    double GetMaxHealth() const { return MaxHealth; }
+
+    UFUNCTION(BlueprintCallable)
+    float GetCurrentHealthNormalized() const;
+    // End Getters
+
+protected:
+    // Callback for Owner's OnTakeAnyDamage delegate.
+    UFUNCTION()
+    void HandleOwnerTakeDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+
+    void BroadcastHealthChanged();
+
+public:
+    TMulticastDelegate<void(UDG_HealthComponent_Lite*, const FDG_DamageEvent&)> OnTakeDamage;
+
+    TMulticastDelegate<void(UDG_HealthComponent_Lite*, const FDG_HealEvent&)> OnReceiveHeal;
+
+    // Called when CurrentHealth or MaxHealth changes
+    TMulticastDelegate<void(UDG_HealthComponent_Lite*)> OnHealthChanged;
+
+    TMulticastDelegate<void(UDG_HealthComponent_Lite*)> OnDeath;
+
+    TMulticastDelegate<void(UDG_HealthComponent_Lite*)> OnRevive;
+
+protected:
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    double CurrentHealth;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    double MaxHealth = 100.0;
+};
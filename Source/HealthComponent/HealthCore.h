@@ -0,0 +1,489 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HealthComponent.h"
+#include "DamageEvent.h"
+#include "HealEvent.h"
+#include "DamageTypeRegistry.h"
+#include "DamageCapture.h"
+#include "HitNumbers.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+
+// Compile time feature set of a health component.
+// Disabled features are removed from the per hit path with if constexpr.
+template<bool bInLogging, bool bInRegen, bool bInMitigation, bool bInStaticEvents, bool bInReplication, bool bInAttribution>
+struct TDG_HealthPolicy
+{
+    // Damage and healing logs, and the threat index built from them.
+    static constexpr bool bLogging = bInLogging;
+
+    // Stop and restart regen on death and revive.
+    static constexpr bool bRegen = bInRegen;
+
+    // Damage mitigation and heal amplification hooks.
+    static constexpr bool bMitigation = bInMitigation;
+
+    // The static OnTakeDamage_Static, OnReceiveHeal_Static, OnDeath_Static and OnRevive_Static delegates.
+    static constexpr bool bStaticEvents = bInStaticEvents;
+
+    // Log changes are batched for replication on servers instead of broadcast immediately, and hit numbers are sent to clients.
+    static constexpr bool bReplication = bInReplication;
+
+    // Kill credit and assists.
+    static constexpr bool bAttribution = bInAttribution;
+
+    // Route every stage through the UDG_HealthComponent virtuals so subclasses can override them.
+    static constexpr bool bOverridableStages = false;
+};
+
+// Everything, used by UDG_HealthComponent.
+struct FDG_HealthPolicy_Full : TDG_HealthPolicy<true, true, true, true, true, true>
+{
+    static constexpr bool bOverridableStages = true;
+};
+
+// Health and the per instance delegates only, used by UDG_HealthComponent_Lite.
+using FDG_HealthPolicy_Lite = TDG_HealthPolicy<false, false, false, false, false, false>;
+
+// The per hit health pipeline, parameterized by a feature policy and the component it runs on.
+// UDG_HealthComponent and UDG_HealthComponent_Lite are thin wrappers that forward to an instantiation of this.
+template<typename PolicyType, typename ComponentType = UDG_HealthComponent>
+struct TDG_HealthCore
+{
+    static constexpr bool bFullComponent = TIsDerivedFrom<ComponentType, UDG_HealthComponent>::Value;
+
+    static_assert(bFullComponent || !(PolicyType::bLogging || PolicyType::bRegen || PolicyType::bMitigation || PolicyType::bStaticEvents
+        || PolicyType::bReplication || PolicyType::bAttribution || PolicyType::bOverridableStages),
+        "Only UDG_HealthComponent has the state for the optional health features.");
+
+    // The BeginPlay work both components share, UDG_HealthComponent sets up its optional features around it.
+    static void BeginPlay(ComponentType& HealthComponent)
+    {
+        if (HealthComponent.GetOwner()->HasAuthority())
+        {
+            // Don't use SetCurrentHealth here as it will trigger Revive.
+            HealthComponent.CurrentHealth = HealthComponent.MaxHealth;
+
+            HealthComponent.GetOwner()->OnTakeAnyDamage.AddDynamic(&HealthComponent, &ComponentType::HandleOwnerTakeDamage);
+        }
+    }
+
+    static void HandleOwnerTakeDamage(ComponentType& HealthComponent, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+    {
+        // The binding is kept while deactivated so pooled actors don't have to rebind.
+        if (!HealthComponent.IsActive())
+        {
+            return;
+        }
+
+        DG_HEALTH_CAPTURE_INPUT(bFullComponent);
+        if constexpr (bFullComponent)
+        {
+            DG_HEALTH_CAPTURE_WRITE(RecordDamage(&HealthComponent, Damage, DamageType, DamageCauser));
+        }
+
+        // Only threat, attribution and hit numbers read the instigator.
+        if constexpr (PolicyType::bLogging || PolicyType::bAttribution || PolicyType::bReplication)
+        {
+            TGuardValue<AActor*> InstigatorGuard(HealthComponent.CurrentInstigator, GetInstigator(InstigatedBy, DamageCauser));
+            HandleHit(HealthComponent, Damage, DamageType, DamageCauser);
+        }
+        else
+        {
+            HandleHit(HealthComponent, Damage, DamageType, DamageCauser);
+        }
+    }
+
+    static void HandleHit(ComponentType& HealthComponent, float Damage, const UDamageType* DamageType, AActor* DamageCauser)
+    {
+        // DamageType can be null when damage is applied without a type.
+        const FDG_DamageTypeInfo DamageTypeInfo = FDG_DamageTypeRegistry::Get().Find(DamageType);
+
+        if (EnumHasAnyFlags(DamageTypeInfo.Traits, EDG_DamageTypeTraits::Heal))
+        {
+            FDG_HealEvent HealEvent = FDG_HealEvent(Damage, DamageType, DamageTypeInfo);
+
+            bool bHealed;
+            if constexpr (PolicyType::bOverridableStages)
+            {
+                bHealed = HealthComponent.HandleReceiveHeal(HealEvent);
+            }
+            else
+            {
+                bHealed = HandleReceiveHeal(HealthComponent, HealEvent);
+            }
+
+            if constexpr (PolicyType::bLogging)
+            {
+                if (bHealed)
+                {
+                    if constexpr (PolicyType::bOverridableStages)
+                    {
+                        HealthComponent.AddActorToHealLog(DamageCauser, HealEvent);
+                    }
+                    else
+                    {
+                        AddActorToHealLog(HealthComponent, DamageCauser, HealEvent);
+                    }
+                }
+            }
+        }
+        else
+        {
+            FDG_DamageEvent DamageEvent = FDG_DamageEvent(Damage, DamageType, DamageTypeInfo);
+
+            bool bDamaged;
+            if constexpr (PolicyType::bOverridableStages)
+            {
+                bDamaged = HealthComponent.HandleTakeDamage(DamageEvent);
+            }
+            else
+            {
+                bDamaged = HandleTakeDamage(HealthComponent, DamageEvent);
+            }
+
+            if constexpr (PolicyType::bLogging)
+            {
+                if (bDamaged)
+                {
+                    if constexpr (PolicyType::bOverridableStages)
+                    {
+                        HealthComponent.AddActorToDamageLog(DamageCauser, DamageEvent);
+                    }
+                    else
+                    {
+                        AddActorToDamageLog(HealthComponent, DamageCauser, DamageEvent);
+                    }
+                }
+            }
+        }
+    }
+
+    static bool HandleTakeDamage(ComponentType& HealthComponent, FDG_DamageEvent& DamageEvent)
+    {
+        if constexpr (PolicyType::bMitigation)
+        {
+            HealthComponent.ApplyDamageMitigation(DamageEvent);
+        }
+
+        if constexpr (PolicyType::bOverridableStages)
+        {
+            return HealthComponent.ApplyFinalDamage(DamageEvent);
+        }
+        else
+        {
+            return ApplyFinalDamage(HealthComponent, DamageEvent);
+        }
+    }
+
+    static bool ApplyFinalDamage(ComponentType& HealthComponent, FDG_DamageEvent& DamageEvent)
+    {
+        const double FinalDamage = DamageEvent.GetFinalDamage();
+        if (FinalDamage > 0.0)
+        {
+            if constexpr (PolicyType::bAttribution)
+            {
+                if (HealthComponent.bAttributionEnabled)
+                {
+                    // Only the health actually removed counts towards credit.
+                    HealthComponent.DamageContributions.Add(HealthComponent.CurrentInstigator, FMath::Min(FinalDamage, HealthComponent.CurrentHealth), HealthComponent.GetWorld()->GetTimeSeconds());
+                }
+            }
+
+            SetCurrentHealth(HealthComponent, HealthComponent.CurrentHealth - FinalDamage);
+            {
+                DG_HEALTH_CAPTURE_STAGE(bFullComponent);
+                HealthComponent.OnTakeDamage.Broadcast(&HealthComponent, DamageEvent);
+            }
+
+            if constexpr (PolicyType::bReplication)
+            {
+                if (UDG_HitNumberSubsystem* HitNumberSubsystem = HealthComponent.HitNumberSubsystem.Get())
+                {
+                    HitNumberSubsystem->AddHitNumber(HealthComponent, HealthComponent.CurrentInstigator, DamageEvent.DamageTypeClass, DamageEvent.GetDamageTypeId(), FinalDamage, false);
+                }
+            }
+
+            if constexpr (PolicyType::bStaticEvents)
+            {
+                UDG_HealthComponent::OnTakeDamage_Static.Broadcast(&HealthComponent, DamageEvent);
+            }
+
+            return true;
+        }
+        return false;
+    }
+
+    static bool HandleReceiveHeal(ComponentType& HealthComponent, FDG_HealEvent& HealEvent)
+    {
+        if constexpr (PolicyType::bMitigation)
+        {
+            HealthComponent.ApplyHealAmplification(HealEvent);
+        }
+
+        if constexpr (PolicyType::bOverridableStages)
+        {
+            return HealthComponent.ApplyFinalHeal(HealEvent);
+        }
+        else
+        {
+            return ApplyFinalHeal(HealthComponent, HealEvent);
+        }
+    }
+
+    static bool ApplyFinalHeal(ComponentType& HealthComponent, FDG_HealEvent& HealEvent)
+    {
+        const double FinalHeal = HealEvent.GetFinalHeal();
+        if (FinalHeal > 0.0)
+        {
+            if constexpr (PolicyType::bAttribution)
+            {
+                if (HealthComponent.bAttributionEnabled)
+                {
+                    HealthComponent.HealingContributions.Add(HealthComponent.CurrentInstigator, FMath::Min(FinalHeal, HealthComponent.MaxHealth - HealthComponent.CurrentHealth), HealthComponent.GetWorld()->GetTimeSeconds());
+                }
+            }
+
+            SetCurrentHealth(HealthComponent, HealthComponent.CurrentHealth + FinalHeal);
+            {
+                DG_HEALTH_CAPTURE_STAGE(bFullComponent);
+                HealthComponent.OnReceiveHeal.Broadcast(&HealthComponent, HealEvent);
+            }
+
+            if constexpr (PolicyType::bReplication)
+            {
+                if (UDG_HitNumberSubsystem* HitNumberSubsystem = HealthComponent.HitNumberSubsystem.Get())
+                {
+                    HitNumberSubsystem->AddHitNumber(HealthComponent, HealthComponent.CurrentInstigator, HealEvent.DamageTypeClass, HealEvent.GetDamageTypeId(), FinalHeal, true);
+                }
+            }
+
+            if constexpr (PolicyType::bStaticEvents)
+            {
+                UDG_HealthComponent::OnReceiveHeal_Static.Broadcast(&HealthComponent, HealEvent);
+            }
+
+            return true;
+        }
+        return false;
+    }
+
+    static void SetCurrentHealth(ComponentType& HealthComponent, double NewHealth)
+    {
+        NewHealth = FMath::Clamp(NewHealth, 0.0, HealthComponent.MaxHealth);
+
+        if (HealthComponent.CurrentHealth != NewHealth)
+        {
+            const double PreviousHealth = HealthComponent.CurrentHealth;
+
+            HealthComponent.CurrentHealth = NewHealth;
+            HealthComponent.BroadcastHealthChanged();
+
+            if (HealthComponent.CurrentHealth == 0.0)
+            {
+                if constexpr (PolicyType::bOverridableStages)
+                {
+                    HealthComponent.Die();
+                }
+                else
+                {
+                    Die(HealthComponent);
+                }
+            }
+            else if (PreviousHealth == 0.0 && HealthComponent.CurrentHealth > 0.0)
+            {
+                if constexpr (PolicyType::bOverridableStages)
+                {
+                    HealthComponent.Revive();
+                }
+                else
+                {
+                    Revive(HealthComponent);
+                }
+            }
+        }
+    }
+
+    static void ApplyDamage(ComponentType& HealthComponent, double Damage)
+    {
+        if (Damage > 0.0)
+        {
+            HealthComponent.SetCurrentHealth(HealthComponent.CurrentHealth - Damage);
+        }
+    }
+
+    static void ApplyHeal(ComponentType& HealthComponent, double Heal)
+    {
+        if (Heal > 0.0)
+        {
+            HealthComponent.SetCurrentHealth(HealthComponent.CurrentHealth + Heal);
+        }
+    }
+
+    static void SetMaxHealth(ComponentType& HealthComponent, double NewMaxHealth)
+    {
+        if (HealthComponent.MaxHealth != NewMaxHealth)
+        {
+            HealthComponent.MaxHealth = NewMaxHealth;
+            HealthComponent.BroadcastHealthChanged();
+        }
+    }
+
+    static float GetCurrentHealthNormalized(const ComponentType& HealthComponent)
+    {
+        check(HealthComponent.MaxHealth != 0);
+        return HealthComponent.CurrentHealth / HealthComponent.MaxHealth;
+    }
+
+    static void Die(ComponentType& HealthComponent)
+    {
+        if (!HealthComponent.IsDead())
+        {
+            return;
+        }
+
+        if constexpr (PolicyType::bRegen)
+        {
+            HealthComponent.StopHealthRegen();
+        }
+
+        if constexpr (PolicyType::bAttribution)
+        {
+            if (HealthComponent.bAttributionEnabled)
+            {
+                HealthComponent.BuildDeathEvent(HealthComponent.DeathEvent);
+                HealthComponent.DamageContributions.Reset();
+                HealthComponent.HealingContributions.Reset();
+            }
+        }
+
+        {
+            DG_HEALTH_CAPTURE_STAGE(bFullComponent);
+            HealthComponent.OnDeath.Broadcast(&HealthComponent);
+        }
+
+        if constexpr (PolicyType::bStaticEvents)
+        {
+            UDG_HealthComponent::OnDeath_Static.Broadcast(&HealthComponent);
+        }
+    }
+
+    static void Revive(ComponentType& HealthComponent)
+    {
+        if (HealthComponent.IsDead())
+        {
+            return;
+        }
+
+        if constexpr (PolicyType::bRegen)
+        {
+            HealthComponent.StartHealthRegen();
+        }
+
+        {
+            DG_HEALTH_CAPTURE_STAGE(bFullComponent);
+            HealthComponent.OnRevive.Broadcast(&HealthComponent);
+        }
+
+        if constexpr (PolicyType::bStaticEvents)
+        {
+            UDG_HealthComponent::OnRevive_Static.Broadcast(&HealthComponent);
+        }
+    }
+
+    static void AddActorToDamageLog(ComponentType& HealthComponent, AActor* Actor, const FDG_DamageEvent& DamageEvent)
+    {
+        if (HealthComponent.bThreatEnabled)
+        {
+            HealthComponent.AddThreat(GetThreatActor(HealthComponent, Actor), DamageEvent.GetFinalDamage());
+        }
+
+        // Logging is suspended below full LOD.
+        if (HealthComponent.HealthLOD != EDG_HealthLOD::Full)
+        {
+            return;
+        }
+
+        AddActorToLog(HealthComponent, HealthComponent.DamageLog, Actor, DamageEvent.GetFinalDamage());
+        MarkLogChanged(HealthComponent, HealthComponent.bDamageLogDirty, HealthComponent.OnDamageLogChanged);
+    }
+
+    static void AddActorToHealLog(ComponentType& HealthComponent, AActor* Actor, const FDG_HealEvent& HealEvent)
+    {
+        if (HealthComponent.bThreatEnabled && HealthComponent.HealingThreatMultiplier > 0.0)
+        {
+            HealthComponent.AddThreat(GetThreatActor(HealthComponent, Actor), HealEvent.GetFinalHeal() * HealthComponent.HealingThreatMultiplier);
+        }
+
+        // Logging is suspended below full LOD.
+        if (HealthComponent.HealthLOD != EDG_HealthLOD::Full)
+        {
+            return;
+        }
+
+        AddActorToLog(HealthComponent, HealthComponent.HealingLog, Actor, HealEvent.GetFinalHeal());
+        MarkLogChanged(HealthComponent, HealthComponent.bHealingLogDirty, HealthComponent.OnHealingLogChanged);
+    }
+
+private:
+    // Credit goes to whoever is behind the hit rather than the projectile or hazard that dealt it.
+    static AActor* GetInstigator(AController* InstigatedBy, AActor* DamageCauser)
+    {
+        if (!InstigatedBy)
+        {
+            return DamageCauser;
+        }
+
+        // The pawn carries the health component the killer's healers are read from.
+        if (APawn* Pawn = InstigatedBy->GetPawn())
+        {
+            return Pawn;
+        }
+        return InstigatedBy;
+    }
+
+    // Threat goes to the instigator of the hit being handled, projectiles and hazards would otherwise each get an entry.
+    // Actor is only used for entries added outside of a hit.
+    static AActor* GetThreatActor(const ComponentType& HealthComponent, AActor* Actor)
+    {
+        return HealthComponent.CurrentInstigator ? HealthComponent.CurrentInstigator : Actor;
+    }
+
+    // Moves Actor to the front of Log, adding Amount to its entry.
+    static void AddActorToLog(ComponentType& HealthComponent, TArray<FDG_HealthComponentLogItem>& Log, AActor* Actor, double Amount)
+    {
+        const int32 Index = Log.IndexOfByKey(FDG_HealthComponentLogItem(Actor));
+
+        if (Index != INDEX_NONE)
+        {
+            auto Item = Log[Index];
+            Item.Amount += Amount;
+            Log.RemoveAt(Index, 1, false);
+            Log.Insert(Item, 0);
+        }
+        else
+        {
+            if (Log.Num() == HealthComponent.LogSize)
+            {
+                Log.RemoveAt(HealthComponent.LogSize - 1, 1, false);
+            }
+
+            Log.Insert(FDG_HealthComponentLogItem(Actor, Actor ? HealthComponent.GetActorName(Actor) : "Unknown", Amount), 0);
+        }
+    }
+
+    static void MarkLogChanged(ComponentType& HealthComponent, bool& bLogDirty, TMulticastDelegate<void(ComponentType*)>& OnLogChanged)
+    {
+        if constexpr (PolicyType::bReplication)
+        {
+            if (HealthComponent.IsServer())
+            {
+                bLogDirty = true;
+                return;
+            }
+        }
+
+        OnLogChanged.Broadcast(&HealthComponent);
+    }
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Gates the health development tools: damage capture and replay, replication stats and benchmarks.
+// Off in shipping builds, a target can define it to override that.
+#ifndef DG_HEALTH_DEV_TOOLS
+#define DG_HEALTH_DEV_TOOLS !UE_BUILD_SHIPPING
+#endif
@@ -0,0 +1,310 @@
+#include "HealthReplicationStats.h"
+
+#if DG_HEALTH_STATS
+
+#include "HealthComponent.h"
+#include "DamageEvent.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Drives scripted damage against replicated health components on a server.
+// The DG.Health.Replication.LoadTest automation test launches PIE with a dedicated server and N in process clients and runs it,
+// DG.Health.LoadTest runs it on an existing server. In process clients share the stats with the server so their OnRep cost
+// is part of the same report, out of process clients can run DG.Health.Stats.Reset / DG.Health.Stats.Dump themselves.
+class FDG_HealthReplicationLoadTest
+{
+public:
+    FDG_HealthReplicationLoadTest(UWorld* InWorld, int32 NumActors, double InHitsPerSecond, double Seconds, const FString& InFilePath)
+        : World(InWorld)
+        , Random(NumActors)
+        , HitsPerSecond(InHitsPerSecond)
+        , EndTime(FPlatformTime::Seconds() + Seconds)
+        , FilePath(InFilePath)
+    {
+        TArray<APlayerController*> PlayerControllers;
+        for (FConstPlayerControllerIterator It = InWorld->GetPlayerControllerIterator(); It; ++It)
+        {
+            PlayerControllers.Add(It->Get());
+        }
+
+        Actors.Reserve(NumActors);
+        for (int32 Index = 0; Index < NumActors; ++Index)
+        {
+            AActor* Actor = InWorld->SpawnActor<AActor>();
+            Actor->bAlwaysRelevant = true;
+            Actor->SetReplicates(true);
+
+            // Logs are COND_OwnerOnly, so spread the actors across the connected players.
+            if (PlayerControllers.Num() > 0)
+            {
+                Actor->SetOwner(PlayerControllers[Index % PlayerControllers.Num()]);
+            }
+
+            UDG_HealthComponent* HealthComponent = NewObject<UDG_HealthComponent>(Actor);
+            HealthComponent->SetIsReplicated(true);
+            HealthComponent->RegisterComponent();
+
+            Actors.Add(Actor);
+        }
+
+        FDG_HealthReplicationStats& Stats = FDG_HealthReplicationStats::Get();
+        Stats.Reset(InWorld);
+        Stats.NumActors = NumActors;
+    }
+
+    bool Tick(float DeltaTime)
+    {
+        UWorld* CurrentWorld = World.Get();
+        if (!CurrentWorld)
+        {
+            return false;
+        }
+
+        if (FPlatformTime::Seconds() >= EndTime)
+        {
+            Finish(CurrentWorld);
+            return false;
+        }
+
+        FDG_HealthReplicationStats& Stats = FDG_HealthReplicationStats::Get();
+
+        HitBudget += HitsPerSecond * DeltaTime;
+        while (HitBudget >= 1.0)
+        {
+            HitBudget -= 1.0;
+
+            AActor* Target = Actors[Random.RandHelper(Actors.Num())].Get();
+            AActor* Causer = Actors[Random.RandHelper(Actors.Num())].Get();
+            if (!Target)
+            {
+                continue;
+            }
+
+            // Mostly damage with some healing so actors keep coming back and both logs churn.
+            const bool bHeal = Random.FRand() < 0.2f;
+            const TSubclassOf<UDamageType> DamageTypeClass = bHeal ? UDG_DamageType_Heal::StaticClass() : UDG_DamageType::StaticClass();
+            UGameplayStatics::ApplyDamage(Target, Random.FRandRange(1.f, 25.f), nullptr, Causer, DamageTypeClass);
+
+            ++Stats.NumHits;
+        }
+
+        return true;
+    }
+
+private:
+    void Finish(UWorld* CurrentWorld)
+    {
+        FDG_HealthReplicationStats& Stats = FDG_HealthReplicationStats::Get();
+
+        const FString Json = Stats.ToJson(CurrentWorld);
+        if (FFileHelper::SaveStringToFile(Json, *FilePath))
+        {
+            UE_LOG(LogHealthComponent, Log, TEXT("Health replication load test written to %s."), *FilePath);
+        }
+
+        Stats.Disable();
+
+        for (const TWeakObjectPtr<AActor>& Actor : Actors)
+        {
+            if (Actor.IsValid())
+            {
+                Actor->Destroy();
+            }
+        }
+    }
+
+    TWeakObjectPtr<UWorld> World;
+
+    TArray<TWeakObjectPtr<AActor>> Actors;
+
+    FRandomStream Random;
+
+    double HitsPerSecond;
+
+    double HitBudget = 0.0;
+
+    double EndTime;
+
+    FString FilePath;
+};
+
+static FAutoConsoleCommandWithWorldAndArgs DG_HealthLoadTestCommand(
+    TEXT("DG.Health.LoadTest"),
+    TEXT("Spawn replicated health components and drive scripted damage on the server, then write a JSON report. Usage: DG.Health.LoadTest <NumActors> <HitsPerSecond> <Seconds> [File]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (!World || World->GetNetMode() == NM_Client || Args.Num() < 3)
+        {
+            UE_LOG(LogHealthComponent, Warning, TEXT("Usage (server only): DG.Health.LoadTest <NumActors> <HitsPerSecond> <Seconds> [File]"));
+            return;
+        }
+
+        const int32 NumActors = FMath::Max(FCString::Atoi(*Args[0]), 1);
+        const double HitsPerSecond = FCString::Atod(*Args[1]);
+        const double Seconds = FCString::Atod(*Args[2]);
+        const FString FilePath = Args.Num() > 3 ? Args[3] : FPaths::Combine(FPaths::ProfilingDir(), TEXT("HealthReplication"),
+            FString::Printf(TEXT("LoadTest-%d-%s.json"), NumActors, *FDateTime::Now().ToString()));
+
+        TSharedRef<FDG_HealthReplicationLoadTest> LoadTest = MakeShared<FDG_HealthReplicationLoadTest>(World, NumActors, HitsPerSecond, Seconds, FilePath);
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([LoadTest](float DeltaTime)
+        {
+            return LoadTest->Tick(DeltaTime);
+        }));
+    }));
+
+#if WITH_EDITOR && WITH_AUTOMATION_TESTS
+
+#include "Editor.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Settings/LevelEditorPlaySettings.h"
+
+namespace DG_HealthReplicationLoadTest
+{
+    // Seconds to wait for every client to get a player controller on the server.
+    static constexpr double ConnectTimeout = 60.0;
+
+    struct FParameters
+    {
+        int32 NumClients = 2;
+
+        int32 NumActors = 100;
+
+        double HitsPerSecond = 1000.0;
+
+        double Seconds = 10.0;
+    };
+
+    static FParameters ParseParameters(const FString& Parameters)
+    {
+        FParameters Result;
+        FParse::Value(*Parameters, TEXT("Clients="), Result.NumClients);
+        FParse::Value(*Parameters, TEXT("Actors="), Result.NumActors);
+        FParse::Value(*Parameters, TEXT("HitsPerSecond="), Result.HitsPerSecond);
+        FParse::Value(*Parameters, TEXT("Seconds="), Result.Seconds);
+        Result.NumClients = FMath::Max(Result.NumClients, 1);
+        Result.NumActors = FMath::Max(Result.NumActors, 1);
+        return Result;
+    }
+
+    static UWorld* FindServerWorld()
+    {
+        for (const FWorldContext& Context : GEngine->GetWorldContexts())
+        {
+            UWorld* World = Context.World();
+            if (Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NM_DedicatedServer)
+            {
+                return World;
+            }
+        }
+        return nullptr;
+    }
+}
+
+// Waits for every client to connect to the PIE server, then runs the load test on it until it finishes.
+class FDG_HealthReplicationLoadTestCommand : public IAutomationLatentCommand
+{
+public:
+    FDG_HealthReplicationLoadTestCommand(FAutomationTestBase* InTest, const DG_HealthReplicationLoadTest::FParameters& InParameters)
+        : Test(InTest)
+        , Parameters(InParameters)
+        , ConnectStartTime(FPlatformTime::Seconds())
+    {
+    }
+
+    virtual bool Update() override
+    {
+        if (!LoadTest)
+        {
+            UWorld* ServerWorld = DG_HealthReplicationLoadTest::FindServerWorld();
+            if (!ServerWorld || ServerWorld->GetNumPlayerControllers() < Parameters.NumClients)
+            {
+                if (FPlatformTime::Seconds() - ConnectStartTime > DG_HealthReplicationLoadTest::ConnectTimeout)
+                {
+                    Test->AddError(FString::Printf(TEXT("%d clients didn't connect to the PIE server in time."), Parameters.NumClients));
+                    return true;
+                }
+                return false;
+            }
+
+            const FString FilePath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("HealthReplication"),
+                FString::Printf(TEXT("LoadTest-%dClients-%d-%s.json"), Parameters.NumClients, Parameters.NumActors, *FDateTime::Now().ToString()));
+
+            LoadTest = MakeShared<FDG_HealthReplicationLoadTest>(ServerWorld, Parameters.NumActors, Parameters.HitsPerSecond, Parameters.Seconds, FilePath);
+            return false;
+        }
+
+        if (LoadTest->Tick(FApp::GetDeltaTime()))
+        {
+            return false;
+        }
+
+        const FDG_HealthReplicationStats& Stats = FDG_HealthReplicationStats::Get();
+        Test->TestTrue(TEXT("Hits were applied on the server"), Stats.NumHits > 0);
+        Test->TestTrue(TEXT("Clients received log updates"), Stats.ClientOnRep.Calls > 0);
+        return true;
+    }
+
+private:
+    FAutomationTestBase* Test;
+
+    DG_HealthReplicationLoadTest::FParameters Parameters;
+
+    double ConnectStartTime;
+
+    TSharedPtr<FDG_HealthReplicationLoadTest> LoadTest;
+};
+
+DEFINE_LATENT_AUTOMATION_COMMAND(FDG_HealthEndPlayCommand);
+
+bool FDG_HealthEndPlayCommand::Update()
+{
+    GEditor->RequestEndPlayMap();
+    return true;
+}
+
+// Headless: UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests DG.Health.Replication.LoadTest; Quit"
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FDG_HealthReplicationLoadAutomationTest, "DG.Health.Replication.LoadTest",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FDG_HealthReplicationLoadAutomationTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+    OutBeautifiedNames.Add(TEXT("2 Clients 100 Actors"));
+    OutTestCommands.Add(TEXT("Clients=2 Actors=100 HitsPerSecond=1000 Seconds=10"));
+
+    OutBeautifiedNames.Add(TEXT("8 Clients 500 Actors"));
+    OutTestCommands.Add(TEXT("Clients=8 Actors=500 HitsPerSecond=5000 Seconds=10"));
+}
+
+bool FDG_HealthReplicationLoadAutomationTest::RunTest(const FString& Parameters)
+{
+    const DG_HealthReplicationLoadTest::FParameters LoadTestParameters = DG_HealthReplicationLoadTest::ParseParameters(Parameters);
+
+    // A dedicated server and the clients, all in this process so the client stats land in the same report.
+    ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+    PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_Client);
+    PlaySettings->SetPlayNumberOfClients(LoadTestParameters.NumClients);
+    PlaySettings->bLaunchSeparateServer = true;
+    PlaySettings->SetRunUnderOneProcess(true);
+
+    FRequestPlaySessionParams PlaySessionParams;
+    PlaySessionParams.WorldType = EPlaySessionWorldType::PlayInEditor;
+    PlaySessionParams.SessionDestination = EPlaySessionDestinationType::InProcess;
+    PlaySessionParams.EditorPlaySettings = PlaySettings;
+    GEditor->RequestPlaySession(PlaySessionParams);
+
+    ADD_LATENT_AUTOMATION_COMMAND(FDG_HealthReplicationLoadTestCommand(this, LoadTestParameters));
+    ADD_LATENT_AUTOMATION_COMMAND(FDG_HealthEndPlayCommand());
+    return true;
+}
+
+#endif // WITH_EDITOR && WITH_AUTOMATION_TESTS
+
+#endif // DG_HEALTH_STATS
@@ -0,0 +1,245 @@
+#include "HealthReplicationStats.h"
+
+#if DG_HEALTH_STATS
+
+#include "HealthComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace DG_HealthReplicationStats
+{
+    static TSharedRef<FJsonObject> CounterToJson(const FDG_HealthStatsCounter& Counter)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetNumberField(TEXT("Calls"), static_cast<double>(Counter.Calls));
+        Object->SetNumberField(TEXT("TotalMs"), Counter.GetMilliseconds());
+        Object->SetNumberField(TEXT("UsPerCall"), Counter.Calls > 0 ? Counter.GetMilliseconds() * 1000.0 / Counter.Calls : 0.0);
+        return Object;
+    }
+
+    static void CompareObjects(const FString& Prefix, const TSharedPtr<FJsonObject>& Current, const TSharedPtr<FJsonObject>& Baseline)
+    {
+        if (!Current.IsValid() || !Baseline.IsValid())
+        {
+            return;
+        }
+
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Current->Values)
+        {
+            const FString Name = Prefix.IsEmpty() ? Field.Key : Prefix + TEXT(".") + Field.Key;
+
+            if (Field.Value->Type == EJson::Object)
+            {
+                const TSharedPtr<FJsonObject>* BaselineObject = nullptr;
+                if (Baseline->TryGetObjectField(Field.Key, BaselineObject))
+                {
+                    CompareObjects(Name, Field.Value->AsObject(), *BaselineObject);
+                }
+            }
+            else if (Field.Value->Type == EJson::Number)
+            {
+                double BaselineValue = 0.0;
+                if (Baseline->TryGetNumberField(Field.Key, BaselineValue))
+                {
+                    const double Value = Field.Value->AsNumber();
+                    const double Change = BaselineValue != 0.0 ? (Value - BaselineValue) / BaselineValue * 100.0 : 0.0;
+                    UE_LOG(LogHealthComponent, Log, TEXT("%-40s %14.3f  baseline %14.3f  %+7.1f%%"), *Name, Value, BaselineValue, Change);
+                }
+            }
+        }
+    }
+}
+
+bool FDG_HealthReplicationStats::bEnabled = false;
+
+FDG_HealthReplicationStats& FDG_HealthReplicationStats::Get()
+{
+    static FDG_HealthReplicationStats Instance;
+    return Instance;
+}
+
+void FDG_HealthReplicationStats::Reset(UWorld* World)
+{
+    ServerNetTickFlush = FDG_HealthStatsCounter();
+    ServerLogCopy = FDG_HealthStatsCounter();
+    ClientOnRep = FDG_HealthStatsCounter();
+    ServerLogCopies = 0;
+    NumHits = 0;
+
+    StartTime = FPlatformTime::Seconds();
+    StartOutBytes.Reset();
+
+    if (const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr)
+    {
+        for (const UNetConnection* Connection : NetDriver->ClientConnections)
+        {
+            StartOutBytes.Add(Connection ? Connection->OutTotalBytes : 0);
+        }
+    }
+
+    BindNetTickFlush(World);
+
+    bEnabled = true;
+}
+
+void FDG_HealthReplicationStats::Disable()
+{
+    UnbindNetTickFlush();
+    bEnabled = false;
+}
+
+void FDG_HealthReplicationStats::BindNetTickFlush(UWorld* World)
+{
+    UnbindNetTickFlush();
+
+    if (!World || World->GetNetMode() == NM_Client || World->GetNetMode() == NM_Standalone)
+    {
+        return;
+    }
+
+    TimedWorld = World;
+
+    // The order of the OnTickFlush bindings isn't guaranteed, time from the end of actor ticking instead,
+    // which is broadcast for every world right before the net drivers' TickFlush. OnPostTickFlush is broadcast once all of them are done.
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddLambda([this](UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+    {
+        if (TickedWorld == TimedWorld.Get())
+        {
+            TickFlushStartCycles = FPlatformTime::Cycles64();
+        }
+    });
+
+    PostTickFlushHandle = World->OnPostTickFlush().AddLambda([this](float DeltaSeconds)
+    {
+        if (bEnabled && TickFlushStartCycles != 0)
+        {
+            ServerNetTickFlush.Cycles += FPlatformTime::Cycles64() - TickFlushStartCycles;
+            ++ServerNetTickFlush.Calls;
+        }
+        TickFlushStartCycles = 0;
+    });
+}
+
+void FDG_HealthReplicationStats::UnbindNetTickFlush()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    if (UWorld* World = TimedWorld.Get())
+    {
+        World->OnPostTickFlush().Remove(PostTickFlushHandle);
+    }
+
+    TimedWorld.Reset();
+    PostActorTickHandle.Reset();
+    PostTickFlushHandle.Reset();
+    TickFlushStartCycles = 0;
+}
+
+FString FDG_HealthReplicationStats::ToJson(UWorld* World) const
+{
+    const double Seconds = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_SMALL_NUMBER);
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetNumberField(TEXT("DurationSeconds"), Seconds);
+    Root->SetNumberField(TEXT("NumActors"), NumActors);
+    Root->SetNumberField(TEXT("NumHits"), static_cast<double>(NumHits));
+
+    TSharedRef<FJsonObject> Server = MakeShared<FJsonObject>();
+    Server->SetObjectField(TEXT("NetTickFlush"), DG_HealthReplicationStats::CounterToJson(ServerNetTickFlush));
+    Server->SetObjectField(TEXT("LogCopy"), DG_HealthReplicationStats::CounterToJson(ServerLogCopy));
+    Server->SetNumberField(TEXT("LogCopies"), static_cast<double>(ServerLogCopies));
+    Root->SetObjectField(TEXT("Server"), Server);
+
+    TSharedRef<FJsonObject> Client = MakeShared<FJsonObject>();
+    Client->SetObjectField(TEXT("OnRep"), DG_HealthReplicationStats::CounterToJson(ClientOnRep));
+    Root->SetObjectField(TEXT("Client"), Client);
+
+    TArray<TSharedPtr<FJsonValue>> Connections;
+    double TotalBytesPerSecond = 0.0;
+
+    if (const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr)
+    {
+        for (int32 Index = 0; Index < NetDriver->ClientConnections.Num(); ++Index)
+        {
+            const UNetConnection* Connection = NetDriver->ClientConnections[Index];
+            if (!Connection)
+            {
+                continue;
+            }
+
+            const int64 StartBytes = StartOutBytes.IsValidIndex(Index) ? StartOutBytes[Index] : 0;
+            const double BytesPerSecond = (Connection->OutTotalBytes - StartBytes) / Seconds;
+            TotalBytesPerSecond += BytesPerSecond;
+
+            TSharedRef<FJsonObject> ConnectionObject = MakeShared<FJsonObject>();
+            ConnectionObject->SetStringField(TEXT("Address"), Connection->LowLevelGetRemoteAddress());
+            ConnectionObject->SetNumberField(TEXT("OutBytesPerSecond"), BytesPerSecond);
+            Connections.Add(MakeShared<FJsonValueObject>(ConnectionObject));
+        }
+    }
+
+    // Averaged so runs with a different number of clients can still be compared.
+    Server->SetNumberField(TEXT("OutBytesPerConnectionPerSecond"), Connections.Num() > 0 ? TotalBytesPerSecond / Connections.Num() : 0.0);
+    Root->SetArrayField(TEXT("Connections"), Connections);
+
+    FString Json;
+    const TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+    FJsonSerializer::Serialize(Root, Writer);
+    return Json;
+}
+
+void FDG_HealthReplicationStats::CompareToBaseline(const FString& Json, const FString& BaselineJson)
+{
+    TSharedPtr<FJsonObject> Current;
+    TSharedPtr<FJsonObject> Baseline;
+
+    if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Current)
+        || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline))
+    {
+        UE_LOG(LogHealthComponent, Warning, TEXT("Health replication stats: could not parse the report or its baseline."));
+        return;
+    }
+
+    DG_HealthReplicationStats::CompareObjects(FString(), Current, Baseline);
+}
+
+// Begin Console Commands
+static FAutoConsoleCommandWithWorld DG_HealthStatsResetCommand(
+    TEXT("DG.Health.Stats.Reset"),
+    TEXT("Clear the health replication counters and start collecting."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+    {
+        FDG_HealthReplicationStats::Get().Reset(World);
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs DG_HealthStatsDumpCommand(
+    TEXT("DG.Health.Stats.Dump"),
+    TEXT("Write the health replication counters as JSON. Usage: DG.Health.Stats.Dump [File] [BaselineFile]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const FString Json = FDG_HealthReplicationStats::Get().ToJson(World);
+
+        const FString FilePath = Args.Num() > 0 ? Args[0] : FPaths::Combine(FPaths::ProfilingDir(), TEXT("HealthReplication"),
+            FString::Printf(TEXT("%s-%s.json"), World && World->GetNetMode() < NM_Client ? TEXT("Server") : TEXT("Client"), *FDateTime::Now().ToString()));
+
+        if (FFileHelper::SaveStringToFile(Json, *FilePath))
+        {
+            UE_LOG(LogHealthComponent, Log, TEXT("Health replication stats written to %s."), *FilePath);
+        }
+
+        FString BaselineJson;
+        if (Args.Num() > 1 && FFileHelper::LoadFileToString(BaselineJson, *Args[1]))
+        {
+            FDG_HealthReplicationStats::CompareToBaseline(Json, BaselineJson);
+        }
+    }));
+// End Console Commands
+
+#endif // DG_HEALTH_STATS
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HealthDevTools.h"
+
+#ifndef DG_HEALTH_STATS
+#define DG_HEALTH_STATS DG_HEALTH_DEV_TOOLS
+#endif
+
+#if DG_HEALTH_STATS
+
+class UWorld;
+
+struct FDG_HealthStatsCounter
+{
+    uint64 Calls = 0;
+
+    uint64 Cycles = 0;
+
+    double GetMilliseconds() const { return FPlatformTime::ToMilliseconds64(Cycles); }
+};
+
+// Process wide counters for the log replication path.
+// In PIE or a multi process test the server and clients fill different counters.
+class HEALTHCOMPONENT_API FDG_HealthReplicationStats
+{
+public:
+    static FDG_HealthReplicationStats& Get();
+
+    static bool IsEnabled() { return bEnabled; }
+
+    // Clears all counters and starts collecting. World's net driver flush is timed until Disable.
+    void Reset(UWorld* World);
+
+    void Disable();
+
+    // Called by the server when a dirty log is copied for replication.
+    void AddLogCopy()
+    {
+        if (bEnabled)
+        {
+            ++ServerLogCopies;
+        }
+    }
+
+    // Writes the counters and the per connection bandwidth of World's net driver as JSON.
+    FString ToJson(UWorld* World) const;
+
+    // Logs the relative change of every counter against a report written by ToJson.
+    static void CompareToBaseline(const FString& Json, const FString& BaselineJson);
+
+    // Server: time spent in the net drivers' TickFlush, where replicated properties (the logs included) are compared, serialized and sent.
+    // This covers every replicated actor, compare runs with and without health components to isolate their cost.
+    FDG_HealthStatsCounter ServerNetTickFlush;
+
+    // Server: time spent copying dirty logs in UDG_HealthComponent::ReplicateLogs.
+    FDG_HealthStatsCounter ServerLogCopy;
+
+    // Client: time spent in OnRep_DamageLog and OnRep_HealingLog.
+    FDG_HealthStatsCounter ClientOnRep;
+
+    uint64 ServerLogCopies = 0;
+
+    // Set by the load test driver.
+    int32 NumActors = 0;
+
+    uint64 NumHits = 0;
+
+private:
+    void BindNetTickFlush(UWorld* World);
+
+    void UnbindNetTickFlush();
+
+    static bool bEnabled;
+
+    double StartTime = 0.0;
+
+    TWeakObjectPtr<UWorld> TimedWorld;
+
+    FDelegateHandle PostActorTickHandle;
+
+    FDelegateHandle PostTickFlushHandle;
+
+    uint64 TickFlushStartCycles = 0;
+
+    // Total bytes sent per client connection when the stats were reset, keyed by connection index.
+    TArray<int64> StartOutBytes;
+};
+
+struct FDG_HealthStatsScope
+{
+    explicit FDG_HealthStatsScope(FDG_HealthStatsCounter& InCounter)
+        : Counter(FDG_HealthReplicationStats::IsEnabled() ? &InCounter : nullptr)
+        , StartCycles(Counter ? FPlatformTime::Cycles64() : 0)
+    {
+    }
+
+    ~FDG_HealthStatsScope()
+    {
+        if (Counter)
+        {
+            Counter->Cycles += FPlatformTime::Cycles64() - StartCycles;
+            ++Counter->Calls;
+        }
+    }
+
+private:
+    FDG_HealthStatsCounter* Counter;
+
+    uint64 StartCycles;
+};
+
+#define DG_HEALTH_STATS_SCOPE(CounterName) FDG_HealthStatsScope PREPROCESSOR_JOIN(HealthStatsScope_, __LINE__)(FDG_HealthReplicationStats::Get().CounterName)
+
+#else
+
+#define DG_HEALTH_STATS_SCOPE(CounterName)
+
+#endif // DG_HEALTH_STATS
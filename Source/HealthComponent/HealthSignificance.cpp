@@ -0,0 +1,167 @@
+#include "HealthSignificance.h"
+#include "HealthComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+UDG_HealthSignificanceSubsystem::UDG_HealthSignificanceSubsystem()
+{
+    SetSignificanceFunction(FDG_HealthSignificanceFunction());
+}
+
+void UDG_HealthSignificanceSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (HealthComponents.Num() == 0)
+    {
+        return;
+    }
+
+    Context.ViewLocations.Reset();
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        if (const APlayerController* PlayerController = It->Get())
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            Context.ViewLocations.Add(ViewLocation);
+        }
+    }
+
+    {
+        TGuardValue<bool> TickingGuard(bTicking, true);
+
+        // OnHealthChanged listeners can register and unregister components, so iterate by index.
+        // Components registered during the pass are added past Num and wait for the next one.
+        const int32 Num = HealthComponents.Num();
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            if (UDG_HealthComponent* HealthComponent = HealthComponents[Index].Get())
+            {
+                HealthComponent->SetHealthLOD(SignificanceFunction(*HealthComponent, Context));
+                HealthComponent->FlushHealthChanged();
+            }
+            else
+            {
+                bHasEmptySlots = true;
+            }
+        }
+    }
+
+    if (bHasEmptySlots)
+    {
+        Compact();
+    }
+}
+
+TStatId UDG_HealthSignificanceSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UDG_HealthSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UDG_HealthSignificanceSubsystem::Register(UDG_HealthComponent* HealthComponent)
+{
+    if (HealthComponent->SignificanceIndex == INDEX_NONE)
+    {
+        HealthComponent->SignificanceIndex = HealthComponents.Add(HealthComponent);
+    }
+}
+
+void UDG_HealthSignificanceSubsystem::Unregister(UDG_HealthComponent* HealthComponent)
+{
+    const int32 Index = HealthComponent->SignificanceIndex;
+    if (Index == INDEX_NONE)
+    {
+        return;
+    }
+
+    HealthComponent->SignificanceIndex = INDEX_NONE;
+
+    if (bTicking)
+    {
+        HealthComponents[Index].Reset();
+        bHasEmptySlots = true;
+        return;
+    }
+
+    HealthComponents.RemoveAtSwap(Index);
+    if (HealthComponents.IsValidIndex(Index) && HealthComponents[Index].IsValid())
+    {
+        HealthComponents[Index]->SignificanceIndex = Index;
+    }
+}
+
+void UDG_HealthSignificanceSubsystem::SetSignificanceFunction(FDG_HealthSignificanceFunction InSignificanceFunction)
+{
+    if (InSignificanceFunction)
+    {
+        SignificanceFunction = MoveTemp(InSignificanceFunction);
+    }
+    else
+    {
+        SignificanceFunction = [this](const UDG_HealthComponent& HealthComponent, const FDG_HealthSignificanceContext& InContext)
+        {
+            return GetDefaultSignificance(HealthComponent, InContext);
+        };
+    }
+}
+
+void UDG_HealthSignificanceSubsystem::Compact()
+{
+    int32 NumKept = 0;
+    for (const TWeakObjectPtr<UDG_HealthComponent>& WeakHealthComponent : HealthComponents)
+    {
+        if (UDG_HealthComponent* HealthComponent = WeakHealthComponent.Get())
+        {
+            HealthComponent->SignificanceIndex = NumKept;
+            HealthComponents[NumKept++] = HealthComponent;
+        }
+    }
+
+    HealthComponents.SetNum(NumKept, false);
+    bHasEmptySlots = false;
+}
+
+bool UDG_HealthSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+EDG_HealthLOD UDG_HealthSignificanceSubsystem::GetDefaultSignificance(const UDG_HealthComponent& HealthComponent, const FDG_HealthSignificanceContext& InContext) const
+{
+    const AActor* Owner = HealthComponent.GetOwner();
+
+    // Without viewers (ie: a server with nobody connected) there is nothing to base the LOD on.
+    if (!Owner || InContext.ViewLocations.Num() == 0)
+    {
+        return EDG_HealthLOD::Full;
+    }
+
+    const FVector Location = Owner->GetActorLocation();
+
+    double MinDistanceSquared = TNumericLimits<double>::Max();
+    for (const FVector& ViewLocation : InContext.ViewLocations)
+    {
+        MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Location, ViewLocation));
+    }
+
+    const EDG_HealthLOD CurrentLOD = HealthComponent.GetHealthLOD();
+    const auto GetThresholdSquared = [this, CurrentLOD](float Distance, EDG_HealthLOD LOD)
+    {
+        return FMath::Square(CurrentLOD > LOD ? FMath::Max(Distance - HysteresisDistance, 0.f) : Distance);
+    };
+
+    if (MinDistanceSquared <= GetThresholdSquared(FullDistance, EDG_HealthLOD::Full))
+    {
+        return EDG_HealthLOD::Full;
+    }
+
+    if (MinDistanceSquared <= GetThresholdSquared(ReducedDistance, EDG_HealthLOD::Reduced))
+    {
+        return EDG_HealthLOD::Reduced;
+    }
+
+    return EDG_HealthLOD::Minimal;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HealthSignificance.generated.h"
+
+class UDG_HealthComponent;
+
+// Level of detail of a health component's processing.
+UENUM(BlueprintType)
+enum class EDG_HealthLOD : uint8
+{
+    // Everything runs at full fidelity.
+    Full,
+
+    // Regen ticks less often, logging is suspended and OnHealthChanged is coalesced.
+    Reduced,
+
+    // Same as Reduced with an even coarser regen interval.
+    Minimal,
+};
+
+// Data gathered once per pass and shared by every evaluation.
+struct FDG_HealthSignificanceContext
+{
+    // View locations of every player controller.
+    TArray<FVector> ViewLocations;
+};
+
+using FDG_HealthSignificanceFunction = TFunction<EDG_HealthLOD(const UDG_HealthComponent&, const FDG_HealthSignificanceContext&)>;
+
+// Evaluates the LOD of every health component with bUseSignificance in one pass per frame,
+// and flushes the OnHealthChanged broadcasts they coalesced.
+UCLASS()
+class HEALTHCOMPONENT_API UDG_HealthSignificanceSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UDG_HealthSignificanceSubsystem();
+
+    // Begin TickableWorldSubsystem Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    // End TickableWorldSubsystem Interface
+
+    void Register(UDG_HealthComponent* HealthComponent);
+
+    void Unregister(UDG_HealthComponent* HealthComponent);
+
+    // Replaces the significance callback. Passing an unset function restores the distance based default.
+    void SetSignificanceFunction(FDG_HealthSignificanceFunction InSignificanceFunction);
+
+    // Distances used by the default significance callback.
+    float FullDistance = 2500.f;
+
+    float ReducedDistance = 10000.f;
+
+    // How far inside a distance a component has to be to move back to the finer LOD, so one hovering around it doesn't flip every pass.
+    float HysteresisDistance = 250.f;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    EDG_HealthLOD GetDefaultSignificance(const UDG_HealthComponent& HealthComponent, const FDG_HealthSignificanceContext& Context) const;
+
+    // Removes the empty slots left by a pass and updates the indices of the components that moved.
+    void Compact();
+
+    TArray<TWeakObjectPtr<UDG_HealthComponent>> HealthComponents;
+
+    // Set during a pass, components unregistered meanwhile leave an empty slot instead of moving another one.
+    bool bTicking = false;
+
+    bool bHasEmptySlots = false;
+
+    FDG_HealthSignificanceFunction SignificanceFunction;
+
+    FDG_HealthSignificanceContext Context;
+};
@@ -0,0 +1,246 @@
+#include "HitNumbers.h"
+#include "HealthComponent.h"
+#include "HealEvent.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/CoreNet.h"
+
+namespace DG_HitNumbers
+{
+    // Rejects corrupted or hostile batches before allocating.
+    static constexpr uint32 MaxHitNumbersPerBatch = 256;
+
+    // Count and dropped count.
+    static constexpr int32 EstimatedBatchHeaderBytes = 4;
+
+    // Three object references once their NetGUIDs are acked, a packed amount, a packed location and the heal bit.
+    static constexpr int32 EstimatedHitNumberBytes = 20;
+
+    static APlayerController* GetOwningPlayerController(AActor* Actor)
+    {
+        for (; Actor; Actor = Actor->GetOwner())
+        {
+            if (APlayerController* PlayerController = Cast<APlayerController>(Actor))
+            {
+                return PlayerController;
+            }
+
+            // Covers pawns that are not owned by their controller.
+            if (const APawn* Pawn = Cast<APawn>(Actor))
+            {
+                if (APlayerController* PlayerController = Cast<APlayerController>(Pawn->GetController()))
+                {
+                    return PlayerController;
+                }
+            }
+        }
+        return nullptr;
+    }
+}
+
+bool FDG_HitNumberBatch::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    bOutSuccess = true;
+
+    // Whether every object reference was mapped, returned as NetSerialize expects.
+    bool bMapped = true;
+
+    uint32 Num = HitNumbers.Num();
+    Ar.SerializeIntPacked(Num);
+
+    if (Ar.IsLoading())
+    {
+        if (Num > DG_HitNumbers::MaxHitNumbersPerBatch)
+        {
+            Ar.SetError();
+            bOutSuccess = false;
+            return true;
+        }
+        HitNumbers.SetNum(Num);
+    }
+
+    for (FDG_HitNumber& HitNumber : HitNumbers)
+    {
+        // Unresolved references (ie: a target that hasn't replicated yet) aren't an error, the number is just skipped when received.
+        UObject* Target = HitNumber.Target.Get();
+        bMapped &= Map->SerializeObject(Ar, AActor::StaticClass(), Target);
+
+        UObject* Source = HitNumber.Source.Get();
+        bMapped &= Map->SerializeObject(Ar, AActor::StaticClass(), Source);
+
+        UObject* DamageTypeClass = HitNumber.DamageTypeClass.Get();
+        bMapped &= Map->SerializeObject(Ar, UClass::StaticClass(), DamageTypeClass);
+
+        uint8 bHeal = HitNumber.bHeal;
+        Ar.SerializeBits(&bHeal, 1);
+
+        // Numbers are shown as whole values, anything that made it here removed or restored at least one point.
+        uint32 Amount = static_cast<uint32>(FMath::Clamp<double>(FMath::RoundToDouble(HitNumber.Amount), 1.0, MAX_uint32));
+        Ar.SerializeIntPacked(Amount);
+
+        bOutSuccess &= SerializePackedVector<1, 24>(HitNumber.Location, Ar);
+
+        if (Ar.IsLoading())
+        {
+            HitNumber.Target = Cast<AActor>(Target);
+            HitNumber.Source = Cast<AActor>(Source);
+            HitNumber.DamageTypeClass = Cast<UClass>(DamageTypeClass);
+            HitNumber.bHeal = bHeal != 0;
+            HitNumber.Amount = Amount;
+        }
+    }
+
+    uint32 NumDroppedPacked = NumDropped;
+    Ar.SerializeIntPacked(NumDroppedPacked);
+    NumDropped = NumDroppedPacked;
+
+    return bMapped;
+}
+
+TMulticastDelegate<void(UDG_HealthComponent*, const FDG_DamageEvent&, const FDG_HitNumber&)> UDG_HitNumberComponent::OnDamageNumber_Static;
+TMulticastDelegate<void(UDG_HealthComponent*, const FDG_HealEvent&, const FDG_HitNumber&)> UDG_HitNumberComponent::OnHealNumber_Static;
+
+UDG_HitNumberComponent::UDG_HitNumberComponent(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    SetIsReplicatedByDefault(true);
+}
+
+void UDG_HitNumberComponent::ClientReceiveHitNumbers_Implementation(const FDG_HitNumberBatch& Batch)
+{
+    if (Batch.NumDropped > 0)
+    {
+        UE_LOG(LogHealthComponent, Verbose, TEXT("%d hit numbers were dropped by the server's byte budget."), Batch.NumDropped);
+    }
+
+    for (const FDG_HitNumber& HitNumber : Batch.HitNumbers)
+    {
+        // The target hasn't replicated to this client yet or is already gone.
+        AActor* Target = HitNumber.Target.Get();
+        if (!Target)
+        {
+            continue;
+        }
+
+        UDG_HealthComponent* HealthComponent = Target->FindComponentByClass<UDG_HealthComponent>();
+        const UDamageType* DamageType = HitNumber.DamageTypeClass ? HitNumber.DamageTypeClass->GetDefaultObject<UDamageType>() : nullptr;
+
+        if (HitNumber.bHeal)
+        {
+            OnHealNumber_Static.Broadcast(HealthComponent, FDG_HealEvent(HitNumber.Amount, DamageType), HitNumber);
+        }
+        else
+        {
+            OnDamageNumber_Static.Broadcast(HealthComponent, FDG_DamageEvent(HitNumber.Amount, DamageType), HitNumber);
+        }
+    }
+}
+
+void UDG_HitNumberSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    for (auto It = Buffers.CreateIterator(); It; ++It)
+    {
+        FConnectionBuffer& Buffer = It.Value();
+        if (!Buffer.PlayerController.IsValid())
+        {
+            It.RemoveCurrent();
+            continue;
+        }
+
+        if (Buffer.Batch.HitNumbers.Num() > 0)
+        {
+            Flush(Buffer);
+        }
+    }
+}
+
+TStatId UDG_HitNumberSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UDG_HitNumberSubsystem, STATGROUP_Tickables);
+}
+
+void UDG_HitNumberSubsystem::AddHitNumber(const UDG_HealthComponent& Target, AActor* Source, TSubclassOf<UDamageType> DamageTypeClass, uint16 DamageTypeId, double Amount, bool bHeal)
+{
+    AActor* TargetActor = Target.GetOwner();
+
+    FDG_HitNumber HitNumber;
+    HitNumber.Target = TargetActor;
+    HitNumber.Source = Source;
+    HitNumber.DamageTypeClass = DamageTypeClass;
+    HitNumber.Amount = Amount;
+    HitNumber.Location = TargetActor->GetActorLocation();
+    HitNumber.bHeal = bHeal;
+
+    const FHitNumberKey Key{TargetActor, Source, DamageTypeId, bHeal};
+
+    APlayerController* TargetPlayerController = DG_HitNumbers::GetOwningPlayerController(TargetActor);
+    if (TargetPlayerController)
+    {
+        AddToBuffer(TargetPlayerController, Key, HitNumber);
+    }
+
+    APlayerController* SourcePlayerController = DG_HitNumbers::GetOwningPlayerController(Source);
+    if (SourcePlayerController && SourcePlayerController != TargetPlayerController)
+    {
+        AddToBuffer(SourcePlayerController, Key, HitNumber);
+    }
+}
+
+bool UDG_HitNumberSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDG_HitNumberSubsystem::AddToBuffer(APlayerController* PlayerController, const FHitNumberKey& Key, const FDG_HitNumber& HitNumber)
+{
+    FConnectionBuffer& Buffer = Buffers.FindOrAdd(PlayerController);
+    Buffer.PlayerController = PlayerController;
+
+    if (const int32* Index = Buffer.HitNumberIndices.Find(Key))
+    {
+        FDG_HitNumber& Merged = Buffer.Batch.HitNumbers[*Index];
+        Merged.Amount += HitNumber.Amount;
+        Merged.Location = HitNumber.Location;
+        return;
+    }
+
+    Buffer.HitNumberIndices.Add(Key, Buffer.Batch.HitNumbers.Add(HitNumber));
+}
+
+void UDG_HitNumberSubsystem::Flush(FConnectionBuffer& Buffer)
+{
+    UDG_HitNumberComponent* Receiver = Buffer.Receiver.Get();
+    if (!Receiver)
+    {
+        APlayerController* PlayerController = Buffer.PlayerController.Get();
+        Receiver = PlayerController->FindComponentByClass<UDG_HitNumberComponent>();
+        if (!Receiver)
+        {
+            Receiver = NewObject<UDG_HitNumberComponent>(PlayerController);
+            Receiver->RegisterComponent();
+        }
+        Buffer.Receiver = Receiver;
+    }
+
+    TArray<FDG_HitNumber>& HitNumbers = Buffer.Batch.HitNumbers;
+
+    // Keep the biggest numbers when over budget, the small ones are the least missed.
+    const int32 MaxHitNumbers = FMath::Clamp((ByteBudget - DG_HitNumbers::EstimatedBatchHeaderBytes) / DG_HitNumbers::EstimatedHitNumberBytes, 1, static_cast<int32>(DG_HitNumbers::MaxHitNumbersPerBatch));
+    if (HitNumbers.Num() > MaxHitNumbers)
+    {
+        HitNumbers.Sort([](const FDG_HitNumber& A, const FDG_HitNumber& B) { return A.Amount > B.Amount; });
+        Buffer.Batch.NumDropped = HitNumbers.Num() - MaxHitNumbers;
+        HitNumbers.SetNum(MaxHitNumbers, false);
+    }
+
+    Receiver->ClientReceiveHitNumbers(Buffer.Batch);
+
+    // Keep the allocations, the same connections usually get hit numbers again next frame.
+    HitNumbers.Reset();
+    Buffer.HitNumberIndices.Reset();
+    Buffer.Batch.NumDropped = 0;
+}
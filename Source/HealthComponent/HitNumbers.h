@@ -0,0 +1,150 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/ObjectKey.h"
+#include "HitNumbers.generated.h"
+
+struct FDG_DamageEvent;
+struct FDG_HealEvent;
+class APlayerController;
+class UDamageType;
+class UDG_HealthComponent;
+
+// A damage or heal number, merged per (target, source, damage type) for a frame.
+USTRUCT()
+struct HEALTHCOMPONENT_API FDG_HitNumber
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TWeakObjectPtr<AActor> Target;
+
+    UPROPERTY()
+    TWeakObjectPtr<AActor> Source;
+
+    UPROPERTY()
+    TSubclassOf<UDamageType> DamageTypeClass;
+
+    // Quantized to a whole number when sent.
+    UPROPERTY()
+    double Amount = 0.0;
+
+    // Quantized to a centimeter when sent.
+    UPROPERTY()
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY()
+    bool bHeal = false;
+};
+
+// All the hit numbers for a connection since the last flush, sent as a single unreliable RPC.
+USTRUCT()
+struct HEALTHCOMPONENT_API FDG_HitNumberBatch
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FDG_HitNumber> HitNumbers;
+
+    // Hit numbers that didn't fit the byte budget.
+    UPROPERTY()
+    int32 NumDropped = 0;
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FDG_HitNumberBatch> : public TStructOpsTypeTraitsBase2<FDG_HitNumberBatch>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
+
+// Receives hit number batches on the owning client. Added to player controllers by UDG_HitNumberSubsystem,
+// or add it to your player controller class so the first batches aren't dropped while it replicates.
+UCLASS(meta = (BlueprintSpawnableComponent))
+class HEALTHCOMPONENT_API UDG_HitNumberComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UDG_HitNumberComponent(const FObjectInitializer& ObjectInitializer);
+
+    UFUNCTION(Client, Unreliable)
+    void ClientReceiveHitNumbers(const FDG_HitNumberBatch& Batch);
+
+    // Same shapes as UDG_HealthComponent::OnTakeDamage and OnReceiveHeal, with the hit number for the source and location.
+    // The health component is null when the target doesn't have one on this client. Its own OnTakeDamage and OnReceiveHeal
+    // are not broadcast for hit numbers, they only fire where the damage is handled.
+    static TMulticastDelegate<void(UDG_HealthComponent*, const FDG_DamageEvent&, const FDG_HitNumber&)> OnDamageNumber_Static;
+
+    static TMulticastDelegate<void(UDG_HealthComponent*, const FDG_HealEvent&, const FDG_HitNumber&)> OnHealNumber_Static;
+};
+
+// Aggregates hit numbers per connection on the server and flushes them once per frame.
+UCLASS()
+class HEALTHCOMPONENT_API UDG_HitNumberSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Begin TickableWorldSubsystem Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    // End TickableWorldSubsystem Interface
+
+    // Queues Amount for the connections owning the target and the source. Called by the health core on the server.
+    // DamageTypeId is the registry id of DamageTypeClass, already on the event being handled.
+    void AddHitNumber(const UDG_HealthComponent& Target, AActor* Source, TSubclassOf<UDamageType> DamageTypeClass, uint16 DamageTypeId, double Amount, bool bHeal);
+
+    // Bytes per connection per flush. Hit numbers past the budget are dropped, smallest first.
+    int32 ByteBudget = 512;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    struct FHitNumberKey
+    {
+        TObjectKey<AActor> Target;
+
+        TObjectKey<AActor> Source;
+
+        // From FDG_DamageTypeRegistry, so different damage types from the same source stay separate numbers.
+        uint16 DamageTypeId = 0;
+
+        bool bHeal = false;
+
+        bool operator==(const FHitNumberKey& Other) const
+        {
+            return Target == Other.Target && Source == Other.Source && DamageTypeId == Other.DamageTypeId && bHeal == Other.bHeal;
+        }
+
+        friend uint32 GetTypeHash(const FHitNumberKey& Key)
+        {
+            return HashCombine(HashCombine(GetTypeHash(Key.Target), GetTypeHash(Key.Source)), (static_cast<uint32>(Key.DamageTypeId) << 1) | static_cast<uint32>(Key.bHeal));
+        }
+    };
+
+    struct FConnectionBuffer
+    {
+        TWeakObjectPtr<APlayerController> PlayerController;
+
+        TWeakObjectPtr<UDG_HitNumberComponent> Receiver;
+
+        FDG_HitNumberBatch Batch;
+
+        TMap<FHitNumberKey, int32> HitNumberIndices;
+    };
+
+    // Merges into the hit number with the same key, or appends a new one.
+    void AddToBuffer(APlayerController* PlayerController, const FHitNumberKey& Key, const FDG_HitNumber& HitNumber);
+
+    void Flush(FConnectionBuffer& Buffer);
+
+    TMap<TObjectKey<APlayerController>, FConnectionBuffer> Buffers;
+};
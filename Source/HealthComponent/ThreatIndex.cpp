@@ -0,0 +1,362 @@
+#include "ThreatIndex.h"
+#include "GameFramework/Actor.h"
+
+namespace DG_ThreatIndex
+{
+    // Stored values grow by exp(DecayRate * (Time - BaseTime)), rebase before that gets anywhere near double range.
+    static constexpr double RebaseExponent = 100.0;
+}
+
+void FDG_ThreatIndex::Configure(int32 InTopK, float HalfLife)
+{
+    TopK = FMath::Max(InTopK, 1);
+    DecayRate = HalfLife > 0.f ? UE_LN2 / HalfLife : 0.0;
+
+    RefreshTopKeys();
+}
+
+bool FDG_ThreatIndex::AddThreat(AActor* Actor, double Amount, double Time)
+{
+    if (!Actor || Amount <= 0.0)
+    {
+        return false;
+    }
+
+    if (DecayRate > 0.0)
+    {
+        if (DecayRate * (Time - BaseTime) > DG_ThreatIndex::RebaseExponent)
+        {
+            Rebase(Time);
+        }
+
+        // Scale the new threat back to BaseTime so it decays with everything else.
+        Amount /= GetDecayScale(Time);
+    }
+
+    const TObjectKey<AActor> Key(Actor);
+    bool bMembershipChanged = false;
+
+    if (const int32* Found = HeapIndices.Find(Key))
+    {
+        const int32 Index = *Found;
+        Heap[Index].Value += Amount;
+        SiftUp(Index);
+    }
+    else
+    {
+        if (Heap.Num() >= CompactThreshold)
+        {
+            bMembershipChanged = Compact();
+        }
+
+        const int32 Index = Heap.Add({ Actor, Key, Amount });
+        HeapIndices.Add(Key, Index);
+        SiftUp(Index);
+    }
+
+    // An actor in the top K was destroyed, rebuild it so the next best live actor takes its place.
+    if (HasInvalidTopKeys())
+    {
+        return RefreshTopKeys() || bMembershipChanged;
+    }
+
+    // Threat only ever increases relative to the other entries, so the cached top K can be patched in place.
+    int32 TopIndex = TopKeys.Find(Key);
+
+    if (TopIndex == INDEX_NONE)
+    {
+        if (TopKeys.Num() < TopK)
+        {
+            TopIndex = TopKeys.Add(Key);
+            bMembershipChanged = true;
+        }
+        else if (GetValue(Key) > GetValue(TopKeys.Last()))
+        {
+            TopIndex = TopKeys.Num() - 1;
+            TopKeys[TopIndex] = Key;
+            bMembershipChanged = true;
+        }
+        else
+        {
+            return bMembershipChanged;
+        }
+    }
+
+    const double Value = GetValue(Key);
+    for (; TopIndex > 0 && Value > GetValue(TopKeys[TopIndex - 1]); --TopIndex)
+    {
+        Swap(TopKeys[TopIndex], TopKeys[TopIndex - 1]);
+    }
+
+    return bMembershipChanged;
+}
+
+bool FDG_ThreatIndex::Remove(const AActor* Actor)
+{
+    const TObjectKey<AActor> Key(Actor);
+
+    const int32* Found = HeapIndices.Find(Key);
+    if (!Found)
+    {
+        return false;
+    }
+
+    RemoveAt(*Found);
+
+    return TopKeys.Contains(Key) && RefreshTopKeys();
+}
+
+void FDG_ThreatIndex::Reset()
+{
+    Heap.Reset();
+    HeapIndices.Reset();
+    TopKeys.Reset();
+    BaseTime = 0.0;
+    CompactThreshold = 16;
+}
+
+AActor* FDG_ThreatIndex::GetTop() const
+{
+    for (const TObjectKey<AActor>& Key : TopKeys)
+    {
+        if (AActor* Actor = Heap[HeapIndices.FindChecked(Key)].Actor.Get())
+        {
+            return Actor;
+        }
+    }
+
+    // Every cached actor was destroyed, look past them.
+    if (TopKeys.Num() == TopK)
+    {
+        TArray<int32> Indices;
+        GatherTop(1, Indices);
+        return Indices.Num() > 0 ? Heap[Indices[0]].Actor.Get() : nullptr;
+    }
+
+    return nullptr;
+}
+
+double FDG_ThreatIndex::GetThreat(const AActor* Actor, double Time) const
+{
+    const int32* Found = HeapIndices.Find(TObjectKey<AActor>(Actor));
+    return Found ? Heap[*Found].Value * GetDecayScale(Time) : 0.0;
+}
+
+void FDG_ThreatIndex::GetTop(int32 K, double Time, TArray<FDG_ThreatEntry>& OutEntries) const
+{
+    OutEntries.Reset(K);
+
+    const double Scale = GetDecayScale(Time);
+
+    if (K <= TopKeys.Num() && !HasInvalidTopKeys())
+    {
+        for (int32 Index = 0; Index < K; ++Index)
+        {
+            const FNode& Node = Heap[HeapIndices.FindChecked(TopKeys[Index])];
+            OutEntries.Add({ Node.Actor, Node.Value * Scale });
+        }
+    }
+    else
+    {
+        TArray<int32> Indices;
+        GatherTop(K, Indices);
+
+        for (const int32 Index : Indices)
+        {
+            OutEntries.Add({ Heap[Index].Actor, Heap[Index].Value * Scale });
+        }
+    }
+}
+
+double FDG_ThreatIndex::GetDecayScale(double Time) const
+{
+    return DecayRate > 0.0 ? FMath::Exp(-DecayRate * (Time - BaseTime)) : 1.0;
+}
+
+void FDG_ThreatIndex::Rebase(double Time)
+{
+    const double Scale = GetDecayScale(Time);
+    for (FNode& Node : Heap)
+    {
+        Node.Value *= Scale;
+    }
+
+    BaseTime = Time;
+}
+
+void FDG_ThreatIndex::SwapNodes(int32 A, int32 B)
+{
+    Heap.Swap(A, B);
+    HeapIndices[Heap[A].Key] = A;
+    HeapIndices[Heap[B].Key] = B;
+}
+
+void FDG_ThreatIndex::SiftUp(int32 Index)
+{
+    while (Index > 0)
+    {
+        const int32 Parent = (Index - 1) / 2;
+        if (Heap[Index].Value <= Heap[Parent].Value)
+        {
+            break;
+        }
+
+        SwapNodes(Index, Parent);
+        Index = Parent;
+    }
+}
+
+void FDG_ThreatIndex::SiftDown(int32 Index)
+{
+    while (true)
+    {
+        const int32 Left = Index * 2 + 1;
+        const int32 Right = Left + 1;
+        int32 Largest = Index;
+
+        if (Left < Heap.Num() && Heap[Left].Value > Heap[Largest].Value)
+        {
+            Largest = Left;
+        }
+
+        if (Right < Heap.Num() && Heap[Right].Value > Heap[Largest].Value)
+        {
+            Largest = Right;
+        }
+
+        if (Largest == Index)
+        {
+            break;
+        }
+
+        SwapNodes(Index, Largest);
+        Index = Largest;
+    }
+}
+
+void FDG_ThreatIndex::RemoveAt(int32 Index)
+{
+    const int32 LastIndex = Heap.Num() - 1;
+    if (Index != LastIndex)
+    {
+        SwapNodes(Index, LastIndex);
+    }
+
+    HeapIndices.Remove(Heap[LastIndex].Key);
+    Heap.Pop();
+
+    if (Index < Heap.Num())
+    {
+        SiftUp(Index);
+        SiftDown(Index);
+    }
+}
+
+bool FDG_ThreatIndex::HasInvalidTopKeys() const
+{
+    for (const TObjectKey<AActor>& Key : TopKeys)
+    {
+        if (!IsValidKey(Key))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FDG_ThreatIndex::Compact()
+{
+    Heap.RemoveAll([](const FNode& Node) { return !Node.Actor.IsValid(); });
+
+    HeapIndices.Reset();
+    for (int32 Index = 0; Index < Heap.Num(); ++Index)
+    {
+        HeapIndices.Add(Heap[Index].Key, Index);
+    }
+
+    for (int32 Index = Heap.Num() / 2 - 1; Index >= 0; --Index)
+    {
+        SiftDown(Index);
+    }
+
+    // Keep compacting amortized when most actors are still alive.
+    CompactThreshold = FMath::Max(16, Heap.Num() * 2);
+
+    return RefreshTopKeys();
+}
+
+bool FDG_ThreatIndex::RefreshTopKeys()
+{
+    TArray<int32> Indices;
+    TArray<TObjectKey<AActor>> InvalidKeys;
+    GatherTop(TopK, Indices, &InvalidKeys);
+
+    // Only the destroyed actors above the K-th live one are removed, the rest are skipped until they surface.
+    // Removing moves other nodes around, gather again until none are in the way.
+    while (InvalidKeys.Num() > 0)
+    {
+        for (const TObjectKey<AActor>& Key : InvalidKeys)
+        {
+            RemoveAt(HeapIndices.FindChecked(Key));
+        }
+
+        InvalidKeys.Reset();
+        GatherTop(TopK, Indices, &InvalidKeys);
+    }
+
+    bool bMembershipChanged = Indices.Num() != TopKeys.Num();
+
+    TArray<TObjectKey<AActor>> NewTopKeys;
+    NewTopKeys.Reserve(Indices.Num());
+
+    for (const int32 Index : Indices)
+    {
+        NewTopKeys.Add(Heap[Index].Key);
+        bMembershipChanged |= !TopKeys.Contains(Heap[Index].Key);
+    }
+
+    TopKeys = MoveTemp(NewTopKeys);
+    return bMembershipChanged;
+}
+
+void FDG_ThreatIndex::GatherTop(int32 K, TArray<int32>& OutIndices, TArray<TObjectKey<AActor>>* OutInvalidKeys) const
+{
+    OutIndices.Reset(K);
+
+    if (Heap.Num() == 0)
+    {
+        return;
+    }
+
+    // Best first search over the heap, only the children of gathered nodes can be next.
+    const auto Greater = [this](int32 A, int32 B) { return Heap[A].Value > Heap[B].Value; };
+
+    TArray<int32, TInlineAllocator<32>> Frontier;
+    Frontier.Add(0);
+
+    while (OutIndices.Num() < K && Frontier.Num() > 0)
+    {
+        int32 Index;
+        Frontier.HeapPop(Index, Greater);
+
+        if (Heap[Index].Actor.IsValid())
+        {
+            OutIndices.Add(Index);
+        }
+        else if (OutInvalidKeys)
+        {
+            OutInvalidKeys->Add(Heap[Index].Key);
+        }
+
+        const int32 Left = Index * 2 + 1;
+        if (Left < Heap.Num())
+        {
+            Frontier.HeapPush(Left, Greater);
+        }
+
+        if (Left + 1 < Heap.Num())
+        {
+            Frontier.HeapPush(Left + 1, Greater);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+
+struct FDG_ThreatEntry
+{
+    TWeakObjectPtr<AActor> Actor;
+
+    double Threat = 0.0;
+};
+
+// Ranks actors by accumulated threat.
+// Entries live in an indexed max heap, and the top K are cached in order so the top 1 is O(1) and the top K is O(K).
+// Decay is exponential and applied lazily: every entry decays by the same factor so the ordering never changes,
+// values are stored relative to a base time and only scaled when read.
+// Destroyed actors are skipped when read and removed once they reach the top K. The rest are compacted away when the heap
+// has doubled since the last compaction, so adding stays amortized O(log N) without the heap growing with dead entries.
+class HEALTHCOMPONENT_API FDG_ThreatIndex
+{
+public:
+    // HalfLife <= 0 disables decay.
+    void Configure(int32 InTopK, float HalfLife);
+
+    // Adds threat to Actor. Returns true if the membership of the top K changed.
+    bool AddThreat(AActor* Actor, double Amount, double Time);
+
+    // Returns true if the membership of the top K changed.
+    bool Remove(const AActor* Actor);
+
+    void Reset();
+
+    AActor* GetTop() const;
+
+    double GetThreat(const AActor* Actor, double Time) const;
+
+    // Fills OutEntries with the K highest threats at Time, highest first.
+    void GetTop(int32 K, double Time, TArray<FDG_ThreatEntry>& OutEntries) const;
+
+    int32 Num() const { return Heap.Num(); }
+
+    int32 GetTopK() const { return TopK; }
+
+private:
+    struct FNode
+    {
+        TWeakObjectPtr<AActor> Actor;
+
+        TObjectKey<AActor> Key;
+
+        // Threat scaled to BaseTime.
+        double Value = 0.0;
+    };
+
+    double GetDecayScale(double Time) const;
+
+    void Rebase(double Time);
+
+    void SwapNodes(int32 A, int32 B);
+
+    void SiftUp(int32 Index);
+
+    void SiftDown(int32 Index);
+
+    void RemoveAt(int32 Index);
+
+    double GetValue(const TObjectKey<AActor>& Key) const { return Heap[HeapIndices.FindChecked(Key)].Value; }
+
+    bool IsValidKey(const TObjectKey<AActor>& Key) const { return Heap[HeapIndices.FindChecked(Key)].Actor.IsValid(); }
+
+    bool HasInvalidTopKeys() const;
+
+    // Removes every destroyed actor and rebuilds the heap. Returns true if the membership of the top K changed.
+    bool Compact();
+
+    // Rebuilds TopKeys from the heap, removing the destroyed actors met on the way. Returns true if the membership changed.
+    bool RefreshTopKeys();
+
+    // Gathers the K best heap indices of live actors in order without modifying the heap.
+    // The destroyed actors passed over are added to OutInvalidKeys when it is set.
+    void GatherTop(int32 K, TArray<int32>& OutIndices, TArray<TObjectKey<AActor>>* OutInvalidKeys = nullptr) const;
+
+    TArray<FNode> Heap;
+
+    TMap<TObjectKey<AActor>, int32> HeapIndices;
+
+    // The TopK best actors, highest first.
+    TArray<TObjectKey<AActor>> TopKeys;
+
+    int32 TopK = 5;
+
+    // Decay per second, 0 when decay is disabled.
+    double DecayRate = 0.0;
+
+    double BaseTime = 0.0;
+
+    // Heap size that triggers the next compaction.
+    int32 CompactThreshold = 16;
+};